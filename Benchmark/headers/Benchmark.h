@@ -0,0 +1,40 @@
+#pragma once
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	// Runs func repetitions times and returns the fastest run in milliseconds, the one least disturbed by the rest of the system
+	template<typename Func>
+	double Measure(int repetitions, Func&& func)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (int i = 0; i < repetitions; i++)
+		{
+			const auto start = std::chrono::high_resolution_clock::now();
+			func();
+			const auto end = std::chrono::high_resolution_clock::now();
+
+			best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+		}
+		return best;
+	}
+
+	// OBJ files given on the command line, relative to the resources folder, or the models of the demo scene without any
+	const std::vector<std::string>& GetModelPaths();
+
+	// TransformBatch::Compute against TransformBatch::ComputeScalar
+	void RunTransformBatch();
+
+	// The same ParallelFor workload with JobSystem running on 1 up to every hardware thread
+	void RunJobSystem();
+
+	// VertexWelder against the std::unordered_map weld it replaced, on the corners of every model in GetModelPaths
+	void RunVertexWelder();
+}
@@ -0,0 +1,72 @@
+#include "Benchmark.h"
+
+#include "core/FileIO.h"
+
+#include <cstring>
+
+namespace
+{
+	struct Entry
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	constexpr Entry BENCHMARKS[] =
+	{
+		{ "transforms", Benchmark::RunTransformBatch },
+		{ "jobs", Benchmark::RunJobSystem },
+		{ "welder", Benchmark::RunVertexWelder },
+	};
+
+	std::vector<std::string> s_ModelPaths{ "models/flat_vase.obj", "models/smooth_vase.obj" };
+}
+
+const std::vector<std::string>& Benchmark::GetModelPaths()
+{
+	return s_ModelPaths;
+}
+
+// Usage: Benchmark [name...] [model.obj...], runs every benchmark when no name is given. Build and run it in Release
+int main(int argc, char** argv)
+{
+	Erupt::Log::Init();
+	Erupt::FileIO::Init();
+
+	std::vector<const char*> names;
+	std::vector<std::string> modelPaths;
+	for (int i = 1; i < argc; i++)
+	{
+		const size_t length = std::strlen(argv[i]);
+		if (length > 4 && std::strcmp(argv[i] + length - 4, ".obj") == 0)
+		{
+			modelPaths.push_back(argv[i]);
+		}
+		else
+		{
+			names.push_back(argv[i]);
+		}
+	}
+
+	if (!modelPaths.empty())
+	{
+		s_ModelPaths = std::move(modelPaths);
+	}
+
+	for (const Entry& benchmark : BENCHMARKS)
+	{
+		bool selected = names.empty();
+		for (const char* name : names)
+		{
+			selected |= std::strcmp(name, benchmark.name) == 0;
+		}
+
+		if (selected)
+		{
+			ERUPT_INFO("Running {0}", benchmark.name);
+			benchmark.run();
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "Benchmark.h"
+
+#include "core/JobSystem.h"
+#include "ECS/TransformBatch.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace Benchmark
+{
+	void RunJobSystem()
+	{
+		// Matrix building like TransformSystem does it, split into as many jobs as a large scene would be
+		constexpr size_t COUNT = 1000000;
+		constexpr size_t GRAIN_SIZE = 4096;
+		constexpr int REPETITIONS = 20;
+
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> value(-10.f, 10.f);
+
+		std::vector<glm::vec3> translations(COUNT), rotations(COUNT), scales(COUNT);
+		for (size_t i = 0; i < COUNT; i++)
+		{
+			translations[i] = { value(random), value(random), value(random) };
+			rotations[i] = { value(random), value(random), value(random) };
+			scales[i] = { 1.f + glm::abs(value(random)), 1.f, 1.f };
+		}
+
+		std::vector<glm::mat4> models(COUNT);
+		std::vector<glm::mat3> normals(COUNT);
+
+		auto workload = [&]()
+		{
+			Erupt::JobSystem::ParallelFor(COUNT, GRAIN_SIZE, [&](size_t begin, size_t end)
+			{
+				Erupt::TransformBatch::Compute(&translations[begin], &rotations[begin], &scales[begin], end - begin, &models[begin], &normals[begin]);
+			});
+		};
+
+		const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		double singleThreaded = 0.0;
+
+		for (uint32_t threads = 1; threads <= maxThreads; threads++)
+		{
+			// Without workers ParallelFor runs inline, that is the baseline the other counts are compared to.
+			// Init(0) would start one worker per hardware thread, so a single thread skips it
+			if (threads > 1)
+			{
+				Erupt::JobSystem::Init(threads - 1);
+			}
+
+			workload();
+			const double milliseconds = Measure(REPETITIONS, workload);
+
+			if (threads > 1)
+			{
+				Erupt::JobSystem::Shutdown();
+			}
+			else
+			{
+				singleThreaded = milliseconds;
+			}
+
+			const double speedup = singleThreaded / milliseconds;
+			ERUPT_INFO("{0} jobs of {1} transforms on {2} threads: {3:.3f} ms, {4:.2f}x speedup, {5:.0f}% efficiency",
+				(COUNT + GRAIN_SIZE - 1) / GRAIN_SIZE, GRAIN_SIZE, threads, milliseconds, speedup, 100.0 * speedup / threads);
+		}
+	}
+}
@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+
+#include "ECS/TransformBatch.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <random>
+#include <vector>
+
+namespace Benchmark
+{
+	void RunTransformBatch()
+	{
+		constexpr size_t COUNT = 100000;
+		constexpr int REPETITIONS = 50;
+
+		std::mt19937 random(42);
+		std::uniform_real_distribution<float> position(-100.f, 100.f);
+		std::uniform_real_distribution<float> angle(-glm::two_pi<float>(), glm::two_pi<float>());
+		std::uniform_real_distribution<float> size(.1f, 10.f);
+
+		std::vector<glm::vec3> translations(COUNT), rotations(COUNT), scales(COUNT);
+		for (size_t i = 0; i < COUNT; i++)
+		{
+			translations[i] = { position(random), position(random), position(random) };
+			rotations[i] = { angle(random), angle(random), angle(random) };
+			scales[i] = { size(random), size(random), size(random) };
+		}
+
+		std::vector<glm::mat4> scalarModels(COUNT), batchModels(COUNT);
+		std::vector<glm::mat3> scalarNormals(COUNT), batchNormals(COUNT);
+
+		const double scalar = Measure(REPETITIONS, [&]()
+		{
+			Erupt::TransformBatch::ComputeScalar(translations.data(), rotations.data(), scales.data(), COUNT, scalarModels.data(), scalarNormals.data());
+		});
+		const double batch = Measure(REPETITIONS, [&]()
+		{
+			Erupt::TransformBatch::Compute(translations.data(), rotations.data(), scales.data(), COUNT, batchModels.data(), batchNormals.data());
+		});
+
+		// The polynomial sincos of the wide paths is not bit exact, a speedup only counts if the results still agree
+		float maxError = 0.f;
+		for (size_t i = 0; i < COUNT; i++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					const float expected = scalarModels[i][column][row];
+					maxError = glm::max(maxError, glm::abs(batchModels[i][column][row] - expected) / glm::max(glm::abs(expected), 1.f));
+				}
+			}
+			for (int column = 0; column < 3; column++)
+			{
+				for (int row = 0; row < 3; row++)
+				{
+					const float expected = scalarNormals[i][column][row];
+					maxError = glm::max(maxError, glm::abs(batchNormals[i][column][row] - expected) / glm::max(glm::abs(expected), 1.f));
+				}
+			}
+		}
+
+		ERUPT_INFO("{0} transforms: scalar {1:.3f} ms, {2} {3:.3f} ms, {4:.2f}x faster, max relative error {5:.2e}",
+			COUNT, scalar, Erupt::TransformBatch::GetInstructionSet(), batch, scalar / batch, maxError);
+	}
+}
@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include "core/JobSystem.h"
+#include "graphics/mesh/ObjParser.h"
+#include "graphics/mesh/VertexWelder.h"
+
+#include "EruptUtils.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include <unordered_map>
+
+namespace
+{
+	// The hash Model::Builder::LoadObj used before the VertexWelder
+	struct VertexHash
+	{
+		size_t operator()(const Erupt::Model::Vertex& vertex) const
+		{
+			size_t seed = 0;
+			Erupt::HashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
+			return seed;
+		}
+	};
+
+	void WeldUnorderedMap(const std::vector<Erupt::Model::Vertex>& corners, std::vector<Erupt::Model::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::unordered_map<Erupt::Model::Vertex, uint32_t, VertexHash> uniqueVertices{};
+
+		vertices.clear();
+		indices.clear();
+		for (const Erupt::Model::Vertex& vertex : corners)
+		{
+			if (uniqueVertices.count(vertex) == 0)
+			{
+				uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(vertex);
+			}
+			indices.push_back(uniqueVertices[vertex]);
+		}
+	}
+}
+
+namespace Benchmark
+{
+	void RunVertexWelder()
+	{
+		constexpr int REPETITIONS = 5;
+
+		// ObjParser and the parallel weld run on the job system
+		Erupt::JobSystem::Init();
+
+		for (const std::string& path : GetModelPaths())
+		{
+			std::vector<Erupt::Model::Vertex> corners;
+			try
+			{
+				if (!Erupt::ObjParser::Parse(path, corners))
+				{
+					ERUPT_WARN("{0} needs tinyobj, skipped", path);
+					continue;
+				}
+			}
+			catch (const std::exception& exception)
+			{
+				ERUPT_WARN("{0} could not be read, skipped: {1}", path, exception.what());
+				continue;
+			}
+
+			std::vector<Erupt::Model::Vertex> mapVertices, serialVertices, vertices;
+			std::vector<uint32_t> mapIndices, serialIndices, indices;
+
+			const double map = Measure(REPETITIONS, [&]() { WeldUnorderedMap(corners, mapVertices, mapIndices); });
+			const double serial = Measure(REPETITIONS, [&]() { Erupt::VertexWelder::WeldSerial(corners.data(), corners.size(), serialVertices, serialIndices); });
+			const double weld = Measure(REPETITIONS, [&]() { Erupt::VertexWelder::Weld(corners.data(), corners.size(), vertices, indices); });
+
+			// The welder keeps the first occurrence order of the old path, so the output has to match exactly
+			const bool identical = serialVertices == mapVertices && serialIndices == mapIndices && vertices == mapVertices && indices == mapIndices;
+
+			ERUPT_INFO("{0}: {1} corners, {2} vertices: unordered_map {3:.3f} ms, WeldSerial {4:.3f} ms ({5:.2f}x), Weld {6:.3f} ms ({7:.2f}x), output {8}",
+				path, corners.size(), mapVertices.size(), map, serial, map / serial, weld, map / weld, identical ? "identical" : "DIFFERENT");
+		}
+
+		Erupt::JobSystem::Shutdown();
+	}
+}
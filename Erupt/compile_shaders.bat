@@ -1,4 +1,5 @@
 C:\VulkanSDK\1.3.236.0\Bin\glslc.exe resources\shaders\simple_shader.vert -o resources\shaders\compiled\simple_shader.vert.spv
+C:\VulkanSDK\1.3.236.0\Bin\glslc.exe resources\shaders\simple_shader_packed.vert -o resources\shaders\compiled\simple_shader_packed.vert.spv
 C:\VulkanSDK\1.3.236.0\Bin\glslc.exe resources\shaders\simple_shader.frag -o resources\shaders\compiled\simple_shader.frag.spv
 
 C:\VulkanSDK\1.3.236.0\Bin\glslc.exe resources\shaders\point_light.vert -o resources\shaders\compiled\point_light.vert.spv
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "ECS/Entity.h"
+
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace Erupt
+{
+	static constexpr size_t MAX_COMPONENTS = 32;
+
+	using ComponentMask = std::bitset<MAX_COMPONENTS>;
+	using ComponentTypeId = uint32_t;
+
+	class IComponentColumn;
+
+	// Hands out a dense id for every component type the first time it is requested.
+	// Every id also remembers how to create a column for its type, so archetypes can be built from a mask alone
+	class ComponentType
+	{
+	public:
+		template<typename T>
+		static ComponentTypeId Id()
+		{
+			static const ComponentTypeId id = Register<T>();
+			return id;
+		}
+
+		static std::unique_ptr<IComponentColumn> CreateColumn(ComponentTypeId id)
+		{
+			assert(s_ColumnFactories[id] != nullptr && "Component type was never registered");
+			return s_ColumnFactories[id]();
+		}
+
+		template<typename... Components>
+		static ComponentMask MaskOf()
+		{
+			ComponentMask mask{};
+			(mask.set(Id<Components>()), ...);
+			return mask;
+		}
+
+	private:
+		template<typename T>
+		static ComponentTypeId Register();
+
+	private:
+		using ColumnFactory = std::unique_ptr<IComponentColumn>(*)();
+
+		inline static std::atomic<ComponentTypeId> s_NextId = 0;
+		inline static std::array<ColumnFactory, MAX_COMPONENTS> s_ColumnFactories{};
+	};
+
+	// Type erased interface so that an archetype can move rows between columns without knowing their types
+	class IComponentColumn
+	{
+	public:
+		virtual ~IComponentColumn() = default;
+
+		virtual std::unique_ptr<IComponentColumn> CreateEmpty() const = 0;
+
+		// Moves the element at index in other to the back of this column
+		virtual void MoveFrom(IComponentColumn& other, size_t index) = 0;
+
+		// Removes the element at index by moving the last element into its place
+		virtual void SwapRemove(size_t index) = 0;
+
+		virtual void Reserve(size_t capacity) = 0;
+
+		// Grows or shrinks the column, new elements are default constructed
+		virtual void Resize(size_t size) = 0;
+		virtual size_t Size() const = 0;
+	};
+
+	template<typename T>
+	class ComponentColumn : public IComponentColumn
+	{
+	public:
+		std::unique_ptr<IComponentColumn> CreateEmpty() const override
+		{
+			return std::make_unique<ComponentColumn<T>>();
+		}
+
+		void MoveFrom(IComponentColumn& other, size_t index) override
+		{
+			auto& source = static_cast<ComponentColumn<T>&>(other);
+			m_Data.push_back(std::move(source.m_Data[index]));
+		}
+
+		void SwapRemove(size_t index) override
+		{
+			assert(index < m_Data.size() && "Column index out of range");
+
+			if (index != m_Data.size() - 1)
+			{
+				m_Data[index] = std::move(m_Data.back());
+			}
+			m_Data.pop_back();
+		}
+
+		void Reserve(size_t capacity) override { m_Data.reserve(capacity); }
+		void Resize(size_t size) override { m_Data.resize(size); }
+		size_t Size() const override { return m_Data.size(); }
+
+		inline std::vector<T>& Data() { return m_Data; }
+
+	private:
+		std::vector<T> m_Data;
+	};
+
+	template<typename T>
+	ComponentTypeId ComponentType::Register()
+	{
+		const ComponentTypeId id = s_NextId++;
+		assert(id < MAX_COMPONENTS && "Component types exceed MAX_COMPONENTS");
+
+		s_ColumnFactories[id] = []() -> std::unique_ptr<IComponentColumn> { return std::make_unique<ComponentColumn<T>>(); };
+		return id;
+	}
+
+	// All entities with the exact same set of components live in one archetype.
+	// Every component type gets its own contiguous array and row i of every array belongs to m_Entities[i]
+	class Archetype
+	{
+	public:
+		Archetype(const ComponentMask& mask);
+		~Archetype() = default;
+
+		Archetype(const Archetype&) = delete;
+		Archetype& operator=(const Archetype&) = delete;
+
+		// Creates an archetype with an empty column for every component in mask
+		static std::unique_ptr<Archetype> Create(const ComponentMask& mask);
+
+		// Creates an archetype with the columns of source that are part of mask (plus an optional new column)
+		static std::unique_ptr<Archetype> CreateFrom(const Archetype& source, const ComponentMask& mask, std::unique_ptr<IComponentColumn> extraColumn = nullptr, ComponentTypeId extraType = 0);
+
+		// Moves the row of source into a new row of this archetype and returns its index.
+		// Only columns present in both archetypes are moved, the caller is responsible for filling in the rest
+		size_t MoveRowFrom(Archetype& source, size_t row);
+
+		// Appends an entity that has no components yet (only valid for the empty archetype)
+		size_t PushEntity(Entity entity);
+
+		// Appends count rows with default constructed components and returns the index of the first one
+		size_t AppendRows(const Entity* entities, size_t count);
+
+		// Removes a row by swapping the last row into its place.
+		// Returns the entity that now occupies row (or an invalid entity if the last row was removed)
+		Entity SwapRemove(size_t row);
+
+		template<typename T>
+		inline std::vector<T>& GetColumn()
+		{
+			const ComponentTypeId id = ComponentType::Id<T>();
+			assert(m_Mask.test(id) && "Archetype does not contain the requested component");
+			return static_cast<ComponentColumn<T>&>(*m_Columns[id]).Data();
+		}
+
+		inline bool Matches(const ComponentMask& required) const { return (m_Mask & required) == required; }
+
+		inline const ComponentMask& GetMask() const { return m_Mask; }
+		inline const std::vector<Entity>& GetEntities() const { return m_Entities; }
+		inline size_t Size() const { return m_Entities.size(); }
+
+	private:
+		ComponentMask m_Mask;
+		std::vector<Entity> m_Entities;
+
+		// Indexed by ComponentTypeId, nullptr when the component is not part of this archetype
+		std::array<std::unique_ptr<IComponentColumn>, MAX_COMPONENTS> m_Columns{};
+	};
+}
@@ -5,22 +5,80 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <memory>
-#include <unordered_map>
 
 namespace Erupt
 {
+	class Registry;
 
-	struct TransformComponent
+	// Local translation, rotation and scale together with the matrices derived from them.
+	// TransformSystem recomputes the matrices only after one of the TRS values changed, so static entities cost nothing per frame
+	class TransformComponent
 	{
-		glm::vec3 translation{};
-		glm::vec3 scale{ 1.f, 1.f, 1.f };
-		glm::vec3 rotation;
+	public:
+		inline const glm::vec3& GetTranslation() const { return m_Translation; }
+		inline const glm::vec3& GetRotation() const { return m_Rotation; }
+		inline const glm::vec3& GetScale() const { return m_Scale; }
+
+		inline void SetTranslation(const glm::vec3& translation) { m_Translation = translation; m_Dirty = true; }
+		inline void SetRotation(const glm::vec3& rotation) { m_Rotation = rotation; m_Dirty = true; }
+		inline void SetScale(const glm::vec3& scale) { m_Scale = scale; m_Dirty = true; }
+
+		inline void Translate(const glm::vec3& offset) { m_Translation += offset; m_Dirty = true; }
+		inline void Rotate(const glm::vec3& angles) { m_Rotation += angles; m_Dirty = true; }
 
+		// True when TRS changed since TransformSystem last computed the matrices
+		inline bool IsDirty() const { return m_Dirty; }
+
+		// Local matrices as computed by the last TransformSystem update.
 		// Matrix corrsponds to Translate * Ry * Rx * Rz * Scale
 		// Rotations correspond to Tait-bryan angles of Y(1), X(2), Z(3)
 		// https://en.wikipedia.org/wiki/Euler_angles#Rotation_matrix
-		glm::mat4 mat4();
-		glm::mat3 normalMatrix();
+		inline const glm::mat4& GetLocalMatrix() const { return m_Matrix; }
+		inline const glm::mat3& GetLocalNormalMatrix() const { return m_NormalMatrix; }
+
+		// World space matrices, the local ones combined with every parent's. Written by TransformSystem
+		inline const glm::mat4& GetWorldMatrix() const { return m_WorldMatrix; }
+		inline const glm::mat3& GetWorldNormalMatrix() const { return m_WorldNormalMatrix; }
+		inline glm::vec3 GetWorldTranslation() const { return glm::vec3(m_WorldMatrix[3]); }
+
+		// World matrices blended between the previous and the current simulation tick, alpha in [0, 1].
+		// Entities that did not move during the last tick return their world matrices unchanged
+		glm::mat4 GetInterpolatedWorldMatrix(float alpha) const;
+		glm::mat3 GetInterpolatedWorldNormalMatrix(float alpha) const;
+		glm::vec3 GetInterpolatedWorldTranslation(float alpha) const;
+
+	private:
+		// Lets the batched path write matrices it computed for many transforms at once
+		friend class TransformSystem;
+
+		glm::vec3 m_Translation{};
+		glm::vec3 m_Scale{ 1.f, 1.f, 1.f };
+		glm::vec3 m_Rotation{};
+
+		glm::mat4 m_Matrix{ 1.f };
+		glm::mat3 m_NormalMatrix{ 1.f };
+		bool m_Dirty = true;
+
+		glm::mat4 m_WorldMatrix{ 1.f };
+		glm::mat3 m_WorldNormalMatrix{ 1.f };
+		bool m_LocalChanged = false;	// local matrices were recomputed during the current TransformSystem update
+		bool m_WorldChanged = false;	// world matrices were recomputed during the current TransformSystem update
+
+		glm::mat4 m_PreviousWorldMatrix{ 1.f };
+		glm::mat3 m_PreviousWorldNormalMatrix{ 1.f };
+		bool m_HasPreviousWorld = false;	// false until the world matrices were computed once
+		bool m_Interpolate = false;			// previous and current world matrices differ
+	};
+
+	struct ColorComponent
+	{
+		glm::vec3 color{};
+	};
+
+	struct ModelComponent
+	{
+		std::shared_ptr<Model> model{};
+		uint32_t lod = 0;	// level of detail drawn last frame, kept to switch levels with hysteresis
 	};
 
 	struct PointLightComponent
@@ -28,39 +86,42 @@ namespace Erupt
 		float lightIntensity = 1.0f;
 	};
 
+	// Rotates the entity by angularVelocity (radians per second, per axis) every simulation tick
+	struct SpinComponent
+	{
+		glm::vec3 angularVelocity{};
+	};
+
+	// Generational handle to an entity, its components live in the Registry that created it.
+	// The index addresses a slot in the registry and the generation is bumped every time that slot is recycled,
+	// so handles to destroyed entities can be detected instead of silently aliasing a new entity
 	class Entity
 	{
 	public:
-		using id_t = unsigned int;
-		using Map = std::unordered_map<id_t, Entity>;
+		using index_t = uint32_t;
+		using generation_t = uint32_t;
+		static constexpr index_t INVALID_INDEX = ~0u;
 
-		inline static Entity CreateEntity()
-		{
-			static id_t currentId = 0;
-			return Entity(currentId++);
-		}
+		Entity() = default;
+		Entity(index_t index, generation_t generation) : m_Index(index), m_Generation(generation) {}
 
-		static Entity MakePointLight(float intensity = 3.f, float radius = 0.1f, glm::vec3 color = glm::vec3(1.f));
+		static Entity MakePointLight(Registry& registry, float intensity = 3.f, float radius = 0.1f, glm::vec3 color = glm::vec3(1.f));
 
-		Entity(const Entity&) = delete;
-		Entity& operator=(const Entity&) = delete;
-		Entity(Entity&&) = default;
-		Entity& operator=(Entity&&) = default;
+		inline index_t GetIndex() const { return m_Index; }
+		inline generation_t GetGeneration() const { return m_Generation; }
+		inline bool IsValid() const { return m_Index != INVALID_INDEX; }
 
-		inline id_t GetId() const { return m_Id; }
+		inline bool operator==(const Entity& other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation; }
+		inline bool operator!=(const Entity& other) const { return !(*this == other); }
 
 	private:
-		inline Entity(id_t entityId) : m_Id(entityId) {}
-
-	public:
-		glm::vec3 m_Color{};
-		TransformComponent m_Transform{};
-
-		// Optional pointer components
-		std::shared_ptr<Model> m_Model{};
-		std::unique_ptr<PointLightComponent> pointLight = nullptr;
+		index_t m_Index = INVALID_INDEX;
+		generation_t m_Generation = 0;
+	};
 
-	private:
-		id_t m_Id;
+	// Attaches an entity to a parent, its TransformComponent is then relative to the parent's world transform
+	struct HierarchyComponent
+	{
+		Entity parent{};
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "ECS/Archetype.h"
+#include "ECS/View.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Erupt
+{
+	// Owns every entity and its components. Components are stored per archetype in contiguous arrays,
+	// so iterating a component set only walks the archetypes that contain it.
+	// Adding or removing components moves the entity to another archetype, which invalidates references to its components.
+	// Entity handles resolve through a slot map: lookups are a plain array index and destroyed slots are recycled through a free list.
+	class Registry
+	{
+	public:
+		Registry();
+		~Registry();
+
+		Registry(const Registry&) = delete;
+		Registry& operator=(const Registry&) = delete;
+
+		Entity CreateEntity();
+		void DestroyEntity(Entity entity);
+
+		// Creates count entities that have exactly the components in mask (default constructed) in one go, meant for bulk loading.
+		// The handles are written to entities. They occupy rows [firstRow, firstRow + count) of the returned archetype,
+		// so their components can be filled in directly through Archetype::GetColumn
+		Archetype& CreateEntities(const ComponentMask& mask, size_t count, Entity* entities, size_t& firstRow);
+
+		// Returns false for default constructed handles and for handles to entities that have been destroyed
+		bool IsValid(Entity entity) const;
+		inline size_t Size() const { return m_AliveCount; }
+
+		inline const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return m_Archetypes; }
+
+		template<typename T, typename... Args>
+		T& AddComponent(Entity entity, Args&&... args)
+		{
+			const ComponentTypeId id = ComponentType::Id<T>();
+
+			EntitySlot& slot = GetSlot(entity);
+			assert(!slot.archetype->GetMask().test(id) && "Entity already has this component");
+
+			ComponentMask mask = slot.archetype->GetMask();
+			mask.set(id);
+
+			Archetype* destination = FindArchetype(mask);
+			if (destination == nullptr)
+			{
+				destination = CreateArchetype(*slot.archetype, mask, std::make_unique<ComponentColumn<T>>(), id);
+			}
+
+			MoveEntity(slot, *destination);
+
+			auto& column = destination->GetColumn<T>();
+			column.push_back(T{ std::forward<Args>(args)... });
+			return column.back();
+		}
+
+		template<typename T>
+		void RemoveComponent(Entity entity)
+		{
+			const ComponentTypeId id = ComponentType::Id<T>();
+
+			EntitySlot& slot = GetSlot(entity);
+			assert(slot.archetype->GetMask().test(id) && "Entity does not have this component");
+
+			ComponentMask mask = slot.archetype->GetMask();
+			mask.reset(id);
+
+			Archetype* destination = FindArchetype(mask);
+			if (destination == nullptr)
+			{
+				destination = CreateArchetype(*slot.archetype, mask);
+			}
+
+			MoveEntity(slot, *destination);
+		}
+
+		template<typename T>
+		T& GetComponent(Entity entity)
+		{
+			EntitySlot& slot = GetSlot(entity);
+			return slot.archetype->GetColumn<T>()[slot.row];
+		}
+
+		template<typename T>
+		T* TryGetComponent(Entity entity)
+		{
+			EntitySlot& slot = GetSlot(entity);
+			if (!slot.archetype->GetMask().test(ComponentType::Id<T>()))
+			{
+				return nullptr;
+			}
+			return &slot.archetype->GetColumn<T>()[slot.row];
+		}
+
+		template<typename T>
+		bool HasComponent(Entity entity) const
+		{
+			return IsValid(entity) && m_Slots[entity.GetIndex()].archetype->GetMask().test(ComponentType::Id<T>());
+		}
+
+		// Returns a view over every entity that has all of Components, see ComponentView.
+		// The matching archetypes are cached per component set and only new archetypes are checked on later calls,
+		// so creating a view every frame is cheap. Safe to call from systems running in parallel
+		template<typename... Components>
+		ComponentView<Components...> View()
+		{
+			return ComponentView<Components...>(GetMatchingArchetypes(ComponentType::MaskOf<Components...>()));
+		}
+
+		// Calls func(count, entities, Components*...) once for every archetype containing all of Components.
+		// The arrays are contiguous and indexed in parallel
+		template<typename... Components, typename Func>
+		void EachChunk(Func&& func)
+		{
+			View<Components...>().EachChunk(std::forward<Func>(func));
+		}
+
+		// Calls func(entity, Components&...) for every entity that has all of Components
+		template<typename... Components, typename Func>
+		void Each(Func&& func)
+		{
+			View<Components...>().Each(std::forward<Func>(func));
+		}
+
+	private:
+		struct EntitySlot
+		{
+			Archetype* archetype = nullptr;	// nullptr while the slot is on the free list
+			size_t row = 0;
+			Entity::generation_t generation = 0;
+			Entity::index_t nextFree = Entity::INVALID_INDEX;
+		};
+
+		// Resolves a handle to its slot, throws if the handle is stale
+		EntitySlot& GetSlot(Entity entity);
+
+		Archetype* FindArchetype(const ComponentMask& mask) const;
+		Archetype* GetOrCreateArchetype(const ComponentMask& mask);
+		Entity::index_t AllocateSlot();
+		Archetype* CreateArchetype(const Archetype& source, const ComponentMask& mask, std::unique_ptr<IComponentColumn> extraColumn = nullptr, ComponentTypeId extraType = 0);
+
+		// Moves all shared components of the entity in slot into destination and patches the slots of both affected rows
+		void MoveEntity(EntitySlot& slot, Archetype& destination);
+
+		struct QueryCache
+		{
+			std::vector<Archetype*> archetypes;
+			size_t scannedArchetypes = 0;	// archetypes are never removed, so only the ones after this need checking
+		};
+
+		const std::vector<Archetype*>& GetMatchingArchetypes(const ComponentMask& mask);
+
+	private:
+		std::vector<EntitySlot>								m_Slots;
+		Entity::index_t										m_FreeListHead = Entity::INVALID_INDEX;
+		size_t												m_AliveCount = 0;
+
+		std::vector<std::unique_ptr<Archetype>>				m_Archetypes;
+		std::unordered_map<ComponentMask, Archetype*>		m_ArchetypeLookup;
+
+		Archetype*											m_EmptyArchetype = nullptr;
+
+		std::mutex											m_QueryMutex;
+		std::unordered_map<ComponentMask, std::unique_ptr<QueryCache>>	m_QueryCaches;
+	};
+}
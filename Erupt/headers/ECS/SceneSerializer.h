@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ECS/Registry.h"
+#include "graphics/AssetManager.h"
+
+#include <string>
+#include <vector>
+
+namespace Erupt
+{
+	// Binary scene format (.escene) laid out to be memory mapped and copied straight into component storage:
+	//     SceneHeader
+	//     SceneChunk[chunkCount]
+	//     model table, modelCount times (uint32 length, path characters, uint32 VertexFormat)
+	//     chunk data, for every chunk one array per component in SceneComponent bit order, each 16 byte aligned
+	// Entities are grouped by component set, so every chunk maps onto a single archetype and is created in one go.
+	// Entity references (hierarchy parents) and models are stored as indices into the scene's entity order and model table
+	class SceneSerializer
+	{
+	public:
+		// Writes every entity of registry that has at least one serializable component
+		static void Save(Registry& registry, const std::string& filePath);
+
+		// Creates the entities of the scene in registry and requests the models it references from assets,
+		// which streams in the ones that are not resident. Returns the created entities in scene order
+		static std::vector<Entity> Load(Registry& registry, AssetManager& assets, const std::string& filePath);
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ECS/Registry.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Erupt
+{
+	// Declares which components a system reads and writes.
+	// Exclusive systems may change the structure of the registry (create or destroy entities, add or remove components)
+	// and therefore never run alongside any other system
+	struct SystemAccess
+	{
+		ComponentMask reads{};
+		ComponentMask writes{};
+		bool exclusive = false;
+
+		template<typename... Components>
+		SystemAccess& Read() { reads |= ComponentType::MaskOf<Components...>(); return *this; }
+
+		template<typename... Components>
+		SystemAccess& Write() { writes |= ComponentType::MaskOf<Components...>(); return *this; }
+
+		inline SystemAccess& Exclusive() { exclusive = true; return *this; }
+
+		// Two systems conflict if either one writes a component the other one touches
+		bool ConflictsWith(const SystemAccess& other) const;
+	};
+
+	// Runs the registered systems once per call to Run, in parallel where their declared access allows it.
+	// Systems that conflict keep the order in which they were added, everything else runs concurrently on the JobSystem.
+	// The dependency graph is rebuilt whenever the set of systems changed
+	class SystemScheduler
+	{
+	public:
+		using SystemFunc = std::function<void(Registry&)>;
+
+		void AddSystem(const std::string& name, const SystemAccess& access, SystemFunc func);
+		void RemoveSystem(const std::string& name);
+
+		// Runs every system and returns once all of them finished, the calling thread helps executing them.
+		// Rethrows the first exception thrown by a system, systems depending on the one that threw are skipped
+		void Run(Registry& registry);
+
+	private:
+		struct SystemNode
+		{
+			std::string name;
+			SystemAccess access;
+			SystemFunc func;
+
+			std::vector<size_t> dependents;
+			size_t dependencyCount = 0;
+		};
+
+		void BuildGraph();
+
+	private:
+		std::vector<SystemNode>	m_Systems;
+		bool					m_GraphDirty = true;
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace Erupt
+{
+	// Builds model and normal matrices (Translate * Ry * Rx * Rz * Scale, see TransformComponent) for many entities at once.
+	// The rotation terms are derived from a single sin/cos evaluation per angle and shared between both matrices.
+	// Compute uses AVX2 (8 entities per iteration) when the CPU supports it, SSE2 (4 entities) on any other x64 CPU
+	// and falls back to the scalar path everywhere else. The AVX2 kernel is the only code built with /arch:AVX2, see TransformBatchAvx2.cpp
+	class TransformBatch
+	{
+	public:
+		static void Compute(
+			const glm::vec3* translations,
+			const glm::vec3* rotations,
+			const glm::vec3* scales,
+			size_t count,
+			glm::mat4* modelMatrices,
+			glm::mat3* normalMatrices);
+
+		static void ComputeScalar(
+			const glm::vec3* translations,
+			const glm::vec3* rotations,
+			const glm::vec3* scales,
+			size_t count,
+			glm::mat4* modelMatrices,
+			glm::mat3* normalMatrices);
+
+		// Name of the instruction set Compute runs with on this CPU, used for logging
+		static const char* GetInstructionSet();
+
+	private:
+		// Defined in TransformBatchAvx2.cpp. Computes the largest multiple of 8 transforms and returns how many that were,
+		// must only be called when UseAvx2 is true
+		static size_t ComputeAvx2(
+			const glm::vec3* translations,
+			const glm::vec3* rotations,
+			const glm::vec3* scales,
+			size_t count,
+			glm::mat4* modelMatrices,
+			glm::mat3* normalMatrices);
+
+		// False when TransformBatchAvx2.cpp was built without AVX2
+		static bool HasAvx2Kernel();
+
+		// HasAvx2Kernel and the CPU and OS support AVX2, checked once
+		static bool UseAvx2();
+	};
+}
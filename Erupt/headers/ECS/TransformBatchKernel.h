@@ -0,0 +1,308 @@
+#pragma once
+
+// The vector kernel behind TransformBatch::Compute, included by TransformBatch.cpp for SSE2 and by TransformBatchAvx2.cpp,
+// the only file built with /arch:AVX2. Everything here has internal linkage and works on plain floats, so no function
+// compiled with AVX2 instructions can be picked by the linker for code that also runs on CPUs without it
+
+#include <cstddef>
+
+#if defined(__AVX2__)
+	#define ERUPT_TRANSFORM_AVX2
+	#define ERUPT_TRANSFORM_SSE2
+	#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ERUPT_TRANSFORM_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(ERUPT_TRANSFORM_SSE2)
+namespace Erupt
+{
+	namespace
+	{
+		// Floats per vec3, mat4 and mat3, glm stores all of them tightly packed
+		constexpr size_t VEC3_FLOATS = 3;
+		constexpr size_t MAT4_FLOATS = 16;
+		constexpr size_t MAT3_FLOATS = 9;
+
+		// Cody-Waite split of pi/2 and minimax polynomials for [-pi/4, pi/4] (from Cephes sinf/cosf)
+		constexpr float TWO_OVER_PI = 0.63661977236758134308f;
+		constexpr float PI_OVER_TWO_1 = 1.5703125f;
+		constexpr float PI_OVER_TWO_2 = 4.837512969970703125e-4f;
+		constexpr float PI_OVER_TWO_3 = 7.54978995489188216e-8f;
+
+		constexpr float SIN_C0 = -1.9515295891e-4f;
+		constexpr float SIN_C1 = 8.3321608736e-3f;
+		constexpr float SIN_C2 = -1.6666654611e-1f;
+
+		constexpr float COS_C0 = 2.443315711809948e-5f;
+		constexpr float COS_C1 = -1.388731625493765e-3f;
+		constexpr float COS_C2 = 4.166664568298827e-2f;
+
+		// Thin wrappers so that the kernel below can be written once for every vector width
+		struct Sse
+		{
+			using F = __m128;
+			using I = __m128i;
+			static constexpr size_t WIDTH = 4;
+
+			static inline F Set(float value) { return _mm_set1_ps(value); }
+			static inline I SetI(int value) { return _mm_set1_epi32(value); }
+			static inline F Add(F a, F b) { return _mm_add_ps(a, b); }
+			static inline F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+			static inline F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+			static inline F Div(F a, F b) { return _mm_div_ps(a, b); }
+			static inline F Xor(F a, F b) { return _mm_xor_ps(a, b); }
+			static inline F Select(F mask, F a, F b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+			static inline I Round(F a) { return _mm_cvtps_epi32(a); }
+			static inline F ToFloat(I a) { return _mm_cvtepi32_ps(a); }
+			static inline I AddI(I a, I b) { return _mm_add_epi32(a, b); }
+			static inline F TestBits(I a, I bits) { return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, bits), bits)); }
+
+			// Splits four consecutive vec3s into one register per component
+			static inline void Load(const float* vectors, F& x, F& y, F& z)
+			{
+				const F x0y0z0x1 = _mm_loadu_ps(vectors);
+				const F y1z1x2y2 = _mm_loadu_ps(vectors + 4);
+				const F z2x3y3z3 = _mm_loadu_ps(vectors + 8);
+
+				const F x2y2x3y3 = _mm_shuffle_ps(y1z1x2y2, z2x3y3z3, _MM_SHUFFLE(2, 1, 3, 2));
+				const F y0z0y1z1 = _mm_shuffle_ps(x0y0z0x1, y1z1x2y2, _MM_SHUFFLE(1, 0, 2, 1));
+
+				x = _mm_shuffle_ps(x0y0z0x1, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+				y = _mm_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+				z = _mm_shuffle_ps(y0z0y1z1, z2x3y3z3, _MM_SHUFFLE(3, 0, 3, 1));
+			}
+		};
+
+#if defined(ERUPT_TRANSFORM_AVX2)
+		struct Avx2
+		{
+			using F = __m256;
+			using I = __m256i;
+			static constexpr size_t WIDTH = 8;
+
+			static inline F Set(float value) { return _mm256_set1_ps(value); }
+			static inline I SetI(int value) { return _mm256_set1_epi32(value); }
+			static inline F Add(F a, F b) { return _mm256_add_ps(a, b); }
+			static inline F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+			static inline F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+			static inline F Div(F a, F b) { return _mm256_div_ps(a, b); }
+			static inline F Xor(F a, F b) { return _mm256_xor_ps(a, b); }
+			static inline F Select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+			static inline I Round(F a) { return _mm256_cvtps_epi32(a); }
+			static inline F ToFloat(I a) { return _mm256_cvtepi32_ps(a); }
+			static inline I AddI(I a, I b) { return _mm256_add_epi32(a, b); }
+			static inline F TestBits(I a, I bits) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, bits), bits)); }
+
+			// Splits eight consecutive vec3s into one register per component, the four lower ones in the low half.
+			// Same shuffles as Sse::Load, done on both halves at once
+			static inline void Load(const float* vectors, F& x, F& y, F& z)
+			{
+				const F x0y0z0x1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(vectors)), _mm_loadu_ps(vectors + 12), 1);
+				const F y1z1x2y2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(vectors + 4)), _mm_loadu_ps(vectors + 16), 1);
+				const F z2x3y3z3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(vectors + 8)), _mm_loadu_ps(vectors + 20), 1);
+
+				const F x2y2x3y3 = _mm256_shuffle_ps(y1z1x2y2, z2x3y3z3, _MM_SHUFFLE(2, 1, 3, 2));
+				const F y0z0y1z1 = _mm256_shuffle_ps(x0y0z0x1, y1z1x2y2, _MM_SHUFFLE(1, 0, 2, 1));
+
+				x = _mm256_shuffle_ps(x0y0z0x1, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+				y = _mm256_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+				z = _mm256_shuffle_ps(y0z0y1z1, z2x3y3z3, _MM_SHUFFLE(3, 0, 3, 1));
+			}
+		};
+#endif
+
+		template<typename S>
+		inline void SinCos(typename S::F x, typename S::F& sinOut, typename S::F& cosOut)
+		{
+			using F = typename S::F;
+			using I = typename S::I;
+
+			// Reduce to r in [-pi/4, pi/4] and the quadrant q so that x = q * pi/2 + r
+			const I quadrant = S::Round(S::Mul(x, S::Set(TWO_OVER_PI)));
+			const F q = S::ToFloat(quadrant);
+
+			F r = S::Sub(x, S::Mul(q, S::Set(PI_OVER_TWO_1)));
+			r = S::Sub(r, S::Mul(q, S::Set(PI_OVER_TWO_2)));
+			r = S::Sub(r, S::Mul(q, S::Set(PI_OVER_TWO_3)));
+
+			const F r2 = S::Mul(r, r);
+
+			F sinR = S::Add(S::Mul(S::Set(SIN_C0), r2), S::Set(SIN_C1));
+			sinR = S::Add(S::Mul(sinR, r2), S::Set(SIN_C2));
+			sinR = S::Add(S::Mul(S::Mul(sinR, r2), r), r);
+
+			F cosR = S::Add(S::Mul(S::Set(COS_C0), r2), S::Set(COS_C1));
+			cosR = S::Add(S::Mul(cosR, r2), S::Set(COS_C2));
+			cosR = S::Mul(S::Mul(cosR, r2), r2);
+			cosR = S::Add(S::Sub(cosR, S::Mul(S::Set(0.5f), r2)), S::Set(1.0f));
+
+			// Odd quadrants swap sin and cos, the sign follows the quadrant of x
+			const F swap = S::TestBits(quadrant, S::SetI(1));
+			const F sinSign = S::TestBits(quadrant, S::SetI(2));
+			const F cosSign = S::TestBits(S::AddI(quadrant, S::SetI(1)), S::SetI(2));
+			const F signBit = S::Set(-0.0f);
+
+			const F s = S::Select(swap, cosR, sinR);
+			const F c = S::Select(swap, sinR, cosR);
+
+			sinOut = S::Xor(s, S::Select(sinSign, signBit, S::Set(0.0f)));
+			cosOut = S::Xor(c, S::Select(cosSign, signBit, S::Set(0.0f)));
+		}
+
+		// Transposes four (x, y, z, w) lanes and writes them as one vec4 column of four consecutive matrices
+		inline void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, float* matrices, int column)
+		{
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			_mm_storeu_ps(matrices + 0 * MAT4_FLOATS + column * 4, x);
+			_mm_storeu_ps(matrices + 1 * MAT4_FLOATS + column * 4, y);
+			_mm_storeu_ps(matrices + 2 * MAT4_FLOATS + column * 4, z);
+			_mm_storeu_ps(matrices + 3 * MAT4_FLOATS + column * 4, w);
+		}
+
+		// Writes the three columns of four consecutive mat3s. Each column is 12 bytes, so the first two are written
+		// with a 16 byte store that gets overwritten by the next column and the last one is written exactly
+		inline void StoreNormalMatrices(const __m128 (&columns)[3][3], float* matrices)
+		{
+			__m128 lanes[3][4];
+			for (int column = 0; column < 3; column++)
+			{
+				__m128 x = columns[column][0];
+				__m128 y = columns[column][1];
+				__m128 z = columns[column][2];
+				__m128 w = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(x, y, z, w);
+
+				lanes[column][0] = x;
+				lanes[column][1] = y;
+				lanes[column][2] = z;
+				lanes[column][3] = w;
+			}
+
+			for (int lane = 0; lane < 4; lane++)
+			{
+				float* destination = matrices + lane * MAT3_FLOATS;
+				_mm_storeu_ps(destination, lanes[0][lane]);
+				_mm_storeu_ps(destination + 3, lanes[1][lane]);
+				_mm_storel_pi(reinterpret_cast<__m64*>(destination + 6), lanes[2][lane]);
+				_mm_store_ss(destination + 8, _mm_movehl_ps(lanes[2][lane], lanes[2][lane]));
+			}
+		}
+
+		// Writes four entities worth of model and normal matrices from 4-wide registers
+		inline void Store(const __m128 (&model)[4][3], const __m128 (&normal)[3][3], float* modelMatrices, float* normalMatrices)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+
+			StoreColumn(model[0][0], model[0][1], model[0][2], zero, modelMatrices, 0);
+			StoreColumn(model[1][0], model[1][1], model[1][2], zero, modelMatrices, 1);
+			StoreColumn(model[2][0], model[2][1], model[2][2], zero, modelMatrices, 2);
+			StoreColumn(model[3][0], model[3][1], model[3][2], one, modelMatrices, 3);
+
+			StoreNormalMatrices(normal, normalMatrices);
+		}
+
+		inline void Store(const __m128 (&model)[4][3], const __m128 (&normal)[3][3], float* modelMatrices, float* normalMatrices, Sse)
+		{
+			Store(model, normal, modelMatrices, normalMatrices);
+		}
+
+#if defined(ERUPT_TRANSFORM_AVX2)
+		// Splits the 8-wide registers into two halves and reuses the 4-wide transposes
+		inline void Store(const __m256 (&model)[4][3], const __m256 (&normal)[3][3], float* modelMatrices, float* normalMatrices, Avx2)
+		{
+			__m128 modelLow[4][3], modelHigh[4][3];
+			__m128 normalLow[3][3], normalHigh[3][3];
+
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 3; row++)
+				{
+					modelLow[column][row] = _mm256_castps256_ps128(model[column][row]);
+					modelHigh[column][row] = _mm256_extractf128_ps(model[column][row], 1);
+				}
+			}
+
+			for (int column = 0; column < 3; column++)
+			{
+				for (int row = 0; row < 3; row++)
+				{
+					normalLow[column][row] = _mm256_castps256_ps128(normal[column][row]);
+					normalHigh[column][row] = _mm256_extractf128_ps(normal[column][row], 1);
+				}
+			}
+
+			Store(modelLow, normalLow, modelMatrices, normalMatrices);
+			Store(modelHigh, normalHigh, modelMatrices + 4 * MAT4_FLOATS, normalMatrices + 4 * MAT3_FLOATS);
+		}
+#endif
+
+		// Computes the largest multiple of S::WIDTH transforms and returns how many that were
+		template<typename S>
+		size_t ComputeWide(
+			const float* translations,
+			const float* rotations,
+			const float* scales,
+			size_t count,
+			float* modelMatrices,
+			float* normalMatrices)
+		{
+			using F = typename S::F;
+
+			const size_t wideCount = count - count % S::WIDTH;
+			const F one = S::Set(1.0f);
+
+			for (size_t i = 0; i < wideCount; i += S::WIDTH)
+			{
+				const float* translation = translations + i * VEC3_FLOATS;
+				const float* rotation = rotations + i * VEC3_FLOATS;
+				const float* scaling = scales + i * VEC3_FLOATS;
+
+				F rotationX, rotationY, rotationZ;
+				S::Load(rotation, rotationX, rotationY, rotationZ);
+
+				F s1, c1, s2, c2, s3, c3;
+				SinCos<S>(rotationY, s1, c1);
+				SinCos<S>(rotationX, s2, c2);
+				SinCos<S>(rotationZ, s3, c3);
+
+				// Rotation matrix columns, see TransformBatch::ComputeScalar
+				const F s1s2 = S::Mul(s1, s2);
+				const F c1s2 = S::Mul(c1, s2);
+
+				const F u[3] = { S::Add(S::Mul(c1, c3), S::Mul(s1s2, s3)), S::Mul(c2, s3), S::Sub(S::Mul(c1s2, s3), S::Mul(c3, s1)) };
+				const F v[3] = { S::Sub(S::Mul(c3, s1s2), S::Mul(c1, s3)), S::Mul(c2, c3), S::Add(S::Mul(c1s2, c3), S::Mul(s1, s3)) };
+				const F w[3] = { S::Mul(c2, s1), S::Xor(s2, S::Set(-0.0f)), S::Mul(c1, c2) };
+
+				F scale[3];
+				S::Load(scaling, scale[0], scale[1], scale[2]);
+				const F inverseScale[3] = { S::Div(one, scale[0]), S::Div(one, scale[1]), S::Div(one, scale[2]) };
+
+				F position[3];
+				S::Load(translation, position[0], position[1], position[2]);
+
+				const F model[4][3] =
+				{
+					{ S::Mul(scale[0], u[0]), S::Mul(scale[0], u[1]), S::Mul(scale[0], u[2]) },
+					{ S::Mul(scale[1], v[0]), S::Mul(scale[1], v[1]), S::Mul(scale[1], v[2]) },
+					{ S::Mul(scale[2], w[0]), S::Mul(scale[2], w[1]), S::Mul(scale[2], w[2]) },
+					{ position[0], position[1], position[2] }
+				};
+
+				const F normal[3][3] =
+				{
+					{ S::Mul(inverseScale[0], u[0]), S::Mul(inverseScale[0], u[1]), S::Mul(inverseScale[0], u[2]) },
+					{ S::Mul(inverseScale[1], v[0]), S::Mul(inverseScale[1], v[1]), S::Mul(inverseScale[1], v[2]) },
+					{ S::Mul(inverseScale[2], w[0]), S::Mul(inverseScale[2], w[1]), S::Mul(inverseScale[2], w[2]) }
+				};
+
+				Store(model, normal, modelMatrices + i * MAT4_FLOATS, normalMatrices + i * MAT3_FLOATS, S{});
+			}
+
+			return wideCount;
+		}
+	}
+}
+#endif
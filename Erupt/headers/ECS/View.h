@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ECS/Archetype.h"
+
+#include <tuple>
+#include <vector>
+
+namespace Erupt
+{
+	// Iterates the entities that have all of Components, obtained through Registry::View.
+	// Only archetypes containing every requested component are visited, so the cost scales with the matching entities
+	// instead of the total entity count. Supports range based for loops:
+	//     for (auto [entity, transform, light] : registry.View<TransformComponent, PointLightComponent>())
+	// Adding or removing components or entities while iterating invalidates the view
+	template<typename... Components>
+	class ComponentView
+	{
+	public:
+		class Iterator
+		{
+		public:
+			using value_type = std::tuple<Entity, Components&...>;
+
+			Iterator(const std::vector<Archetype*>& archetypes, size_t archetypeIndex)
+				: m_Archetypes(&archetypes), m_ArchetypeIndex(archetypeIndex)
+			{
+				LoadArchetype();
+			}
+
+			inline value_type operator*() const
+			{
+				return value_type{ m_Entities[m_Row], std::get<Components*>(m_Columns)[m_Row]... };
+			}
+
+			inline Iterator& operator++()
+			{
+				if (++m_Row == m_Count)
+				{
+					m_ArchetypeIndex++;
+					LoadArchetype();
+				}
+				return *this;
+			}
+
+			inline bool operator==(const Iterator& other) const { return m_ArchetypeIndex == other.m_ArchetypeIndex && m_Row == other.m_Row; }
+			inline bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+		private:
+			// Points the iterator at the first row of the next non-empty archetype
+			void LoadArchetype()
+			{
+				m_Row = 0;
+				while (m_ArchetypeIndex < m_Archetypes->size() && (*m_Archetypes)[m_ArchetypeIndex]->Size() == 0)
+				{
+					m_ArchetypeIndex++;
+				}
+
+				if (m_ArchetypeIndex == m_Archetypes->size())
+				{
+					m_Count = 0;
+					return;
+				}
+
+				Archetype& archetype = *(*m_Archetypes)[m_ArchetypeIndex];
+				m_Count = archetype.Size();
+				m_Entities = archetype.GetEntities().data();
+				m_Columns = std::tuple<Components*...>{ archetype.GetColumn<Components>().data()... };
+			}
+
+		private:
+			const std::vector<Archetype*>*	m_Archetypes;
+			size_t							m_ArchetypeIndex;
+			size_t							m_Row = 0;
+			size_t							m_Count = 0;
+
+			const Entity*					m_Entities = nullptr;
+			std::tuple<Components*...>		m_Columns{};
+		};
+
+		explicit ComponentView(const std::vector<Archetype*>& archetypes) : m_Archetypes(archetypes) {}
+
+		inline Iterator begin() const { return Iterator(m_Archetypes, 0); }
+		inline Iterator end() const { return Iterator(m_Archetypes, m_Archetypes.size()); }
+
+		// Calls func(count, entities, Components*...) once for every non-empty matching archetype.
+		// The arrays are contiguous and indexed in parallel
+		template<typename Func>
+		void EachChunk(Func&& func) const
+		{
+			for (Archetype* archetype : m_Archetypes)
+			{
+				if (archetype->Size() == 0) continue;
+
+				func(archetype->Size(), archetype->GetEntities().data(), archetype->GetColumn<Components>().data()...);
+			}
+		}
+
+		// Calls func(entity, Components&...) for every matching entity
+		template<typename Func>
+		void Each(Func&& func) const
+		{
+			EachChunk([&func](size_t count, const Entity* entities, Components*... components)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					func(entities[i], components[i]...);
+				}
+			});
+		}
+
+		size_t Size() const
+		{
+			size_t size = 0;
+			for (Archetype* archetype : m_Archetypes)
+			{
+				size += archetype->Size();
+			}
+			return size;
+		}
+
+		inline bool IsEmpty() const { return begin() == end(); }
+
+	private:
+		const std::vector<Archetype*>& m_Archetypes;
+	};
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "ECS/Registry.h"
+#include "ECS/SystemScheduler.h"
+
+namespace Erupt
+{
+	// Applies SpinComponent rotations, runs once per simulation tick
+	class SpinSystem
+	{
+	public:
+		void Update(Registry& registry, float deltaTime);
+		static SystemAccess GetAccess();
+	};
+}
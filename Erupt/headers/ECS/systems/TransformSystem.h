@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ECS/Registry.h"
+#include "ECS/SystemScheduler.h"
+
+#include <vector>
+
+namespace Erupt
+{
+	// Refreshes the cached matrices of every transform that changed since the last update.
+	// Dirty transforms are gathered into contiguous arrays and run through the vectorized TransformBatch kernel.
+	// World matrices are then propagated through the HierarchyComponent tree one depth level at a time:
+	// every level only reads the level above it, so the nodes of a level are processed in parallel on the JobSystem,
+	// and a node is only recomputed when its own or one of its ancestors' transforms changed.
+	// The entities whose world matrices changed are collected so later systems can skip everything that stayed static.
+	// Meant to run once per simulation tick: the world matrices of the previous tick are kept for render interpolation
+	class TransformSystem
+	{
+	public:
+		void Update(Registry& registry);
+		static SystemAccess GetAccess();
+
+		inline const std::vector<Entity>& GetChangedEntities() const { return m_ChangedEntities; }
+
+	private:
+		struct HierarchyNode
+		{
+			Entity entity;
+			Entity parent;
+		};
+
+		void UpdateLocalMatrices(Registry& registry);
+
+		// Sorts every entity with a parent into m_Levels by its depth in the hierarchy
+		void BuildLevels(Registry& registry);
+
+		// Returns false if the hierarchy changed since the levels were built and they have to be rebuilt
+		bool PropagateLevels(Registry& registry, bool force);
+
+		size_t CountHierarchyNodes(Registry& registry) const;
+
+	private:
+		// Work per job, smaller batches are not worth handing to other threads.
+		// The batch grain is a multiple of 8 so every job but the last one stays on the vectorized path
+		static constexpr size_t BATCH_GRAIN_SIZE = 1024;
+		static constexpr size_t PROPAGATION_GRAIN_SIZE = 256;
+
+		std::vector<Entity>						m_ChangedEntities;
+
+		// Scratch arrays reused every frame so the batch does not allocate once warmed up
+		std::vector<TransformComponent*>		m_DirtyTransforms;
+		std::vector<glm::vec3>					m_Translations;
+		std::vector<glm::vec3>					m_Rotations;
+		std::vector<glm::vec3>					m_Scales;
+		std::vector<glm::mat4>					m_Matrices;
+		std::vector<glm::mat3>					m_NormalMatrices;
+
+		// m_Levels[0] holds the direct children of root entities, m_Levels[1] their children and so on
+		std::vector<std::vector<HierarchyNode>>	m_Levels;
+		size_t									m_HierarchyNodeCount = 0;
+		bool									m_LevelsBuilt = false;
+	};
+}
@@ -2,24 +2,37 @@
 
 #include "graphics/EruptRenderer.h"
 #include "graphics/EruptDescriptors.h"
+#include "graphics/AssetManager.h"
 
-#include "ECS/Entity.h"
+#include "ECS/Registry.h"
 
 namespace Erupt
 {
 	static constexpr int WINDOW_WIDTH = 800;
 	static constexpr int WINDOW_HEIGHT = 600;
 
+	static constexpr float DEFAULT_TICK_RATE = 60.f;	// simulation ticks per second
+	static constexpr float MAX_FRAME_TIME = 0.25f;		// longer frames are clamped so a hitch does not turn into a burst of ticks
+
 	class Application
 	{
 	public:
-		Application();
+		// Loads the scene file (relative to the resources folder) when one is given, builds the demo scene otherwise.
+		// stagingCapacity sizes the device's staging ring, raise it for scenes that stream in many large models
+		Application(const std::string& scenePath = "", VkDeviceSize stagingCapacity = EruptDevice::DEFAULT_STAGING_CAPACITY);
 		~Application();
 
 		static void Init();
 
 		void Run();
 
+		// Writes the entities to a scene file relative to the resources folder, see SceneSerializer
+		void SaveScene(const std::string& filePath);
+
+		// Rate at which the simulation systems run, independent of the render rate
+		void SetTickRate(float ticksPerSecond);
+		inline float GetTickRate() const { return m_TickRate; }
+
 	private:
 		void LoadEntities();
 
@@ -30,7 +43,10 @@ namespace Erupt
 		EruptRenderer m_EruptRenderer{ m_EruptWindow, m_EruptDevice };
 
 		std::unique_ptr<EruptDescriptorPool> m_GlobalPool{};
-		Entity::Map	m_Entities;
+		ModelLoader		m_ModelLoader{ m_EruptDevice };
+		AssetManager	m_AssetManager{ m_ModelLoader };
+		Registry		m_Registry;
+		float			m_TickRate = DEFAULT_TICK_RATE;
 	};
 
 } // namespace Erupt
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -41,8 +42,47 @@ namespace Erupt
 		/// <returns>Returns true if the file exists and false otherwise</returns>
 		static bool Exists(const std::string& filePath);
 
+		/// <summary>
+		/// Write binary data to a file, replacing its contents. Missing directories are created
+		/// </summary>
+		/// <param name="std::vector<char> data:">Bytes to write to the file</param>
+		/// <param name="std::string filePath:">Realtive to the project root folder file path to the file you would like to write to</param>
+		/// <returns>Returns true if sucessful. If not throws an exception</returns>
+		static bool WriteBinaryFile(const std::vector<char>& data, const std::string& filePath);
+
 	private:
 
 		static std::string m_ResourcesPath;
 	};
+
+	/// <summary>
+	/// Read only memory mapping of a file in the Resources folder. The file is unmapped when the object is destroyed
+	/// </summary>
+	class MappedFile
+	{
+	public:
+		/// <summary>
+		/// Maps the whole file into memory
+		/// </summary>
+		/// <param name="std::string filePath:">Realtive to the project root folder file path to the file you would like to map</param>
+		MappedFile(const std::string& filePath);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline const uint8_t* Data() const { return m_Data; }
+		inline size_t Size() const { return m_Size; }
+
+	private:
+		const uint8_t*	m_Data = nullptr;
+		size_t			m_Size = 0;
+
+#ifdef _WIN32
+		void*			m_File = nullptr;
+		void*			m_Mapping = nullptr;
+#else
+		int				m_File = -1;
+#endif
+	};
 }
\ No newline at end of file
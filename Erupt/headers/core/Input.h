@@ -21,7 +21,7 @@ namespace Erupt
             int lookDown        = GLFW_KEY_DOWN;
         };
 
-        void MoveInPlaneXZ(GLFWwindow* window, float dt, Entity& entity);
+        void MoveInPlaneXZ(GLFWwindow* window, float dt, TransformComponent& transform);
 
 	private:
         KeyMappings m_Keys{};
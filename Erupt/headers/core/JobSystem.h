@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Erupt
+{
+	using Job = std::function<void()>;
+
+	// Tracks a group of jobs. Every job started with a counter increments it and decrements it once finished,
+	// so a counter is done when all of its jobs are. Jobs can also wait on a counter before they start.
+	// A counter must outlive its jobs and may only be reused once Wait returned
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		inline bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+
+		struct DeferredJob
+		{
+			Job job;
+			JobCounter* counter;
+		};
+
+		std::atomic<uint32_t>		m_Count = 0;
+
+		std::mutex					m_Mutex;
+		std::vector<DeferredJob>	m_Dependents;	// jobs waiting for this counter to reach zero
+		std::exception_ptr			m_Exception;	// first exception thrown by one of the jobs
+	};
+
+	// Work-stealing job system. Every worker thread and the main thread own a deque:
+	// the owner pushes and pops at the back, idle threads steal from the front of the others.
+	// Threads that wait on a counter execute pending jobs instead of blocking
+	class JobSystem
+	{
+	public:
+		// Starts threadCount workers, or one per hardware thread minus the main thread when 0
+		static void Init(uint32_t threadCount = 0);
+		static void Shutdown();
+
+		// Queues job. counter (if any) is incremented now and decremented after the job ran.
+		// If dependency is given the job is held back until that counter is done
+		static void Run(Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+		// Queues a long running job, like parsing a model, that only idle workers pick up. Wait never executes it,
+		// so a thread waiting for frame work is not stuck behind it. Runs right away when there are no workers
+		static void RunBackground(Job job, JobCounter* counter = nullptr);
+
+		// Executes pending jobs until counter is done, rethrows the first exception thrown by one of its jobs
+		static void Wait(JobCounter& counter);
+
+		// Splits [0, count) into ranges of at most grainSize and calls func(begin, end) for each of them in parallel.
+		// Returns once every range was processed
+		static void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& func);
+
+		// Number of threads executing jobs, including the main thread
+		static uint32_t GetThreadCount();
+
+	private:
+		struct WorkQueue
+		{
+			std::mutex						mutex;
+			std::deque<JobCounter::DeferredJob>	jobs;
+		};
+
+		static void WorkerLoop(uint32_t queueIndex);
+		static void Push(JobCounter::DeferredJob job);
+		static bool TryExecuteOne();
+		static bool TryExecuteBackground();
+		static void Execute(JobCounter::DeferredJob& job);
+		static void Finish(JobCounter* counter, std::exception_ptr exception);
+
+	private:
+		static std::vector<std::unique_ptr<WorkQueue>>	s_Queues;	// index 0 belongs to the main thread
+		static std::vector<std::thread>					s_Workers;
+		static WorkQueue								s_BackgroundQueue;
+
+		static std::atomic<size_t>						s_QueuedJobs;
+		static std::atomic<bool>						s_Running;
+		static std::mutex								s_WakeMutex;
+		static std::condition_variable					s_WakeCondition;
+
+		static thread_local uint32_t					s_QueueIndex;
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+namespace Erupt
+{
+	// First fit allocator of ranges inside [0, size), used to sub-allocate large GPU buffers.
+	// Free ranges are kept sorted by offset and merged with their neighbours when freed.
+	// Alignments do not have to be powers of two, so vertex buffers can align ranges to their stride
+	class RangeAllocator
+	{
+	public:
+		RangeAllocator(uint64_t size = 0);
+
+		// Offset of a new range of size bytes that is a multiple of alignment, empty if no free range is large enough
+		std::optional<uint64_t> Allocate(uint64_t size, uint64_t alignment = 1);
+
+		// Takes the offset returned by Allocate
+		void Free(uint64_t offset);
+
+		// Adds space at the end, existing ranges keep their offsets
+		void Grow(uint64_t size);
+
+		inline uint64_t GetSize() const { return m_Size; }
+		inline uint64_t GetUsed() const { return m_Used; }
+
+		// End of the last allocated range, everything behind it is free
+		uint64_t GetUsedExtent() const;
+
+	private:
+		void AddFreeRange(uint64_t offset, uint64_t size);
+
+	private:
+		uint64_t								m_Size;
+		uint64_t								m_Used = 0;
+		std::map<uint64_t, uint64_t>			m_FreeRanges;	// offset -> size
+		std::unordered_map<uint64_t, uint64_t>	m_Allocations;	// offset -> size
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "graphics/ModelLoader.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace Erupt
+{
+	// Owns every model loaded from a file, so each file and vertex format is loaded once and shared.
+	// The shared pointers handed out are the handles: a model only the manager holds is unreferenced and stays resident
+	// as a cache until the memory of all models exceeds the budget, then the least recently used ones are freed first.
+	// Models are loaded in the background by a ModelLoader. Main thread only
+	class AssetManager
+	{
+	public:
+		static constexpr size_t DEFAULT_BUDGET = 256ull << 20;
+
+		struct Statistics
+		{
+			size_t assetCount = 0;
+			size_t referencedCount = 0;
+			size_t cpuBytes = 0;
+			size_t gpuBytes = 0;
+			uint64_t evictionCount = 0;
+		};
+
+		AssetManager(ModelLoader& loader, size_t budget = DEFAULT_BUDGET);
+
+		AssetManager(const AssetManager&) = delete;
+		AssetManager& operator=(const AssetManager&) = delete;
+
+		// Returns the resident model of filepath in format, or starts loading it
+		std::shared_ptr<Model> LoadModel(const std::string& filepath, Model::VertexFormat format = Model::VertexFormat::Full);
+
+		// Marks the referenced models as used this frame and evicts unreferenced ones while over budget. Call once per frame
+		void Update();
+
+		// CPU and GPU bytes of all models, evicted down to on the next Update
+		void SetBudget(size_t bytes) { m_Budget = bytes; }
+		inline size_t GetBudget() const { return m_Budget; }
+
+		Statistics GetStatistics() const;
+
+	private:
+		struct Asset
+		{
+			std::shared_ptr<Model> model;
+			uint64_t lastUsed = 0;		// frame the model was referenced last
+		};
+
+		static std::string GetKey(const std::string& filepath, Model::VertexFormat format);
+		static size_t GetMemoryUsage(const Model& model) { return model.GetCpuMemoryUsage() + model.GetGpuMemoryUsage(); }
+
+	private:
+		ModelLoader&							m_Loader;
+		std::unordered_map<std::string, Asset>	m_Assets;
+		size_t									m_Budget;
+		uint64_t								m_Frame = 0;
+		uint64_t								m_EvictionCount = 0;
+	};
+}
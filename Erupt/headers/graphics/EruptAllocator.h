@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/RangeAllocator.h"
+
+#include <vulkan/vulkan.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Erupt
+{
+	struct MemoryBlock;
+
+	// Memory bound to one buffer or image, a range of a larger block
+	struct EruptAllocation
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr;		// start of the range, host visible memory stays mapped for its whole lifetime
+		MemoryBlock* block = nullptr;
+	};
+
+	// Sub-allocates device memory, so buffers and images do not need one vkAllocateMemory each. Every memory type
+	// has its own blocks, which are split with a first fit RangeAllocator. Linear resources (buffers, linear images)
+	// and optimal tiling images never share a block, which keeps them bufferImageGranularity apart without padding.
+	// Allocations of at least half a block get a dedicated block. Owned by EruptDevice, see EruptDevice::GetAllocator
+	class EruptAllocator
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull << 20;
+
+		struct Statistics
+		{
+			uint32_t blockCount = 0;			// vkAllocateMemory calls alive, including dedicated blocks
+			uint32_t dedicatedBlockCount = 0;
+			uint32_t allocationCount = 0;
+			VkDeviceSize reservedBytes = 0;		// size of all blocks
+			VkDeviceSize usedBytes = 0;			// size of all allocations
+		};
+
+		EruptAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+		~EruptAllocator();
+
+		EruptAllocator(const EruptAllocator&) = delete;
+		EruptAllocator& operator=(const EruptAllocator&) = delete;
+
+		EruptAllocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear);
+		void Free(EruptAllocation& allocation);
+
+		// Range to flush or invalidate, grown to nonCoherentAtomSize. Pass VK_WHOLE_SIZE for the rest of the allocation
+		VkMappedMemoryRange GetMappedRange(const EruptAllocation& allocation, VkDeviceSize size, VkDeviceSize offset) const;
+
+		Statistics GetStatistics() const;
+
+	private:
+		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+		MemoryBlock& CreateBlock(uint32_t memoryType, bool linear, VkDeviceSize size, bool dedicated);
+		void DestroyBlock(MemoryBlock& block);
+
+	private:
+		VkDevice							m_Device;
+		VkPhysicalDeviceMemoryProperties	m_MemoryProperties;
+		VkDeviceSize						m_NonCoherentAtomSize;
+		VkDeviceSize						m_BlockSize;
+
+		mutable std::mutex					m_Mutex;
+		std::vector<std::unique_ptr<MemoryBlock>>	m_Blocks;
+	};
+}
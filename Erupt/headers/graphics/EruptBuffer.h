@@ -33,6 +33,7 @@ namespace Erupt
         VkBufferUsageFlags GetUsageFlags() const { return m_UsageFlags; }
         VkMemoryPropertyFlags GetMemoryPropertyFlags() const { return m_MemoryPropertyFlags; }
         VkDeviceSize GetBufferSize() const { return m_BufferSize; }
+        const EruptAllocation& GetAllocation() const { return m_Allocation; }
 
     private:
         static VkDeviceSize GetAlignment(VkDeviceSize instanceSize, VkDeviceSize minOffsetAlignment);
@@ -41,7 +42,7 @@ namespace Erupt
         EruptDevice& m_Device;
         void* m_Mapped = nullptr;
         VkBuffer m_Buffer = VK_NULL_HANDLE;
-        VkDeviceMemory m_Memory = VK_NULL_HANDLE;
+        EruptAllocation m_Allocation{};
 
         VkDeviceSize m_BufferSize;
         uint32_t m_InstanceCount;
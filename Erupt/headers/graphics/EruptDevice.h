@@ -1,13 +1,19 @@
 #pragma once
 
 #include "EruptWindow.h"
+#include "EruptAllocator.h"
 
 // std lib headers
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace Erupt {
 
+	class GeometryPool;
+	class StagingRing;
+	class UploadQueue;
+
 	struct SwapChainSupportDetails 
 	{
 		VkSurfaceCapabilitiesKHR capabilities;
@@ -19,8 +25,10 @@ namespace Erupt {
 	{
 		uint32_t graphicsFamily;
 		uint32_t presentFamily;
+		uint32_t transferFamily;
 		bool graphicsFamilyHasValue = false;
 		bool presentFamilyHasValue = false;
+		bool transferFamilyHasValue = false;	// only for a family without graphics, uploads share the graphics queue otherwise
 		bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
 	};
 
@@ -34,7 +42,10 @@ namespace Erupt {
 		const bool enableValidationLayers = true;
 #endif
 
-		EruptDevice(Window& window);
+		// Size of the staging ring uploads are written into, uploads larger than half of it get a temporary buffer
+		static constexpr VkDeviceSize DEFAULT_STAGING_CAPACITY = 16ull << 20;
+
+		EruptDevice(Window& window, VkDeviceSize stagingCapacity = DEFAULT_STAGING_CAPACITY);
 		~EruptDevice();
 
 		void Init();
@@ -51,29 +62,44 @@ namespace Erupt {
 		VkQueue GraphicsQueue() { return m_GraphicsQueue; }
 		VkQueue PresentQueue() { return m_PresentQueue; }
 
+		// Queue of QueueFamilyIndices::transferFamily, the graphics queue when the device has no such family
+		VkQueue TransferQueue() { return m_TransferQueue; }
+
+		// Memory of all buffers and images created through the device
+		EruptAllocator& GetAllocator() { return *m_Allocator; }
+
+		// Persistently mapped memory that uploads are staged in
+		StagingRing& GetStagingRing() { return *m_StagingRing; }
+
+		// Copies recorded for the frame, submitted together by EruptRenderer
+		UploadQueue& GetUploadQueue() { return *m_UploadQueue; }
+
+		// Vertex and index buffers shared by all models
+		GeometryPool& GetGeometryPool() { return *m_GeometryPool; }
+
 		SwapChainSupportDetails GetSwapChainSupport() { return QuerySwapChainSupport(m_PhysicalDevice); }
 		uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 		QueueFamilyIndices FindPhysicalQueueFamilies() { return FindQueueFamilies(m_PhysicalDevice); }
 		VkFormat FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
-		// Buffer Helper Functions
+		// Buffer Helper Functions, the memory is sub-allocated and returned to GetAllocator with Free
 		void CreateBuffer(
 			VkDeviceSize size,
 			VkBufferUsageFlags usage,
 			VkMemoryPropertyFlags properties,
 			VkBuffer& buffer,
-			VkDeviceMemory& bufferMemory);
+			EruptAllocation& bufferMemory);
 
 		VkCommandBuffer BeginSingleTimeCommands();
 		void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
-		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+		void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
 		void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
 
 		void CreateImageWithInfo(
 			const VkImageCreateInfo& imageInfo,
 			VkMemoryPropertyFlags properties,
 			VkImage& image,
-			VkDeviceMemory& imageMemory);
+			EruptAllocation& imageMemory);
 
 		VkPhysicalDeviceProperties properties;
 
@@ -101,11 +127,18 @@ namespace Erupt {
 		VkPhysicalDevice				m_PhysicalDevice = VK_NULL_HANDLE;
 		Window&							m_Window;
 		VkCommandPool					m_CommandPool;
+		VkDeviceSize					m_StagingCapacity;
 
 		VkDevice						m_Device;
 		VkSurfaceKHR					m_Surface;
 		VkQueue							m_GraphicsQueue;
 		VkQueue							m_PresentQueue;
+		VkQueue							m_TransferQueue;
+
+		std::unique_ptr<EruptAllocator>	m_Allocator;
+		std::unique_ptr<StagingRing>	m_StagingRing;
+		std::unique_ptr<UploadQueue>	m_UploadQueue;
+		std::unique_ptr<GeometryPool>	m_GeometryPool;
 
 		const std::vector<const char*>	m_ValidationLayers = { "VK_LAYER_KHRONOS_validation" };
 		const std::vector<const char*>	m_DeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
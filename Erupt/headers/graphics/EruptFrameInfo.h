@@ -1,7 +1,8 @@
 #pragma once
 
 #include "core/Camera.h"
-#include "ECS/Entity.h"
+#include "ECS/Registry.h"
+#include "graphics/FrameAllocator.h"
 
 // lib
 #include <vulkan/vulkan.h>
@@ -31,10 +32,13 @@ namespace Erupt
 	{
 		int frameIndex;
 		float deltaTime;
+		float interpolationAlpha;	// how far rendering is between the previous and the current simulation tick
 		VkCommandBuffer commandBuffer;
 		Camera& camera;
 		VkDescriptorSet globalDescriptorSet;
+		uint32_t globalUboOffset;	// dynamic offset of this frame's GlobalUbo in the global descriptor set
+		FrameAllocator& frameAllocator;
 
-		Entity::Map& entities;
+		Registry& entities;
 	};
 }
\ No newline at end of file
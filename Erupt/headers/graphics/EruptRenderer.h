@@ -2,6 +2,7 @@
 
 #include "graphics/EruptWindow.h"
 #include "graphics/EruptSwapChain.h"
+#include "graphics/FrameAllocator.h"
 
 #include "core/Log.h"
 
@@ -46,6 +47,9 @@ namespace Erupt
 			return m_CurrentFrameIndex;
 		};
 
+		// Per frame uniform and storage data, allocations made during a frame stay valid until it executed
+		inline FrameAllocator& GetFrameAllocator() { return *m_FrameAllocator; }
+
 	private:
 		void CreateCommandBuffers();
 		void FreeCommandBuffers();
@@ -58,6 +62,7 @@ namespace Erupt
 		std::unique_ptr<EruptSwapChain>	m_EruptSwapChain;
 
 		std::vector<VkCommandBuffer>	m_CommandBuffers;
+		std::unique_ptr<FrameAllocator>	m_FrameAllocator;
 
 		uint32_t m_CurrentImageIndex = 0;
 		int m_CurrentFrameIndex = 0;
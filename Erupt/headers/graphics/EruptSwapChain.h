@@ -72,7 +72,7 @@ namespace Erupt
 		VkRenderPass m_RenderPass;
 
 		std::vector<VkImage>				m_DepthImages;
-		std::vector<VkDeviceMemory>			m_DepthImageMemorys;
+		std::vector<EruptAllocation>		m_DepthImageMemorys;
 		std::vector<VkImageView>			m_DepthImageViews;
 		std::vector<VkImage>				m_SwapChainImages;
 		std::vector<VkImageView>			m_SwapChainImageViews;
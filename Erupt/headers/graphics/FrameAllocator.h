@@ -0,0 +1,67 @@
+#pragma once
+
+#include "graphics/EruptBuffer.h"
+
+#include <cstring>
+#include <memory>
+
+namespace Erupt
+{
+	// Space handed out by the FrameAllocator, valid until the frame it was allocated in executed
+	struct FrameAllocation
+	{
+		VkBuffer buffer = VK_NULL_HANDLE;
+		VkDeviceSize offset = 0;
+		VkDeviceSize size = 0;
+		void* mapped = nullptr;
+
+		// Offset to bind a VK_DESCRIPTOR_TYPE_*_BUFFER_DYNAMIC descriptor of FrameAllocator::GetBuffer with
+		inline uint32_t GetDynamicOffset() const { return static_cast<uint32_t>(offset); }
+	};
+
+	// Per frame uniform and storage data, bump allocated from one persistently mapped buffer with a section per frame
+	// in flight. Allocations are aligned for both uniform and storage buffer offsets, so they can be bound through
+	// dynamic offsets into a single descriptor set instead of a buffer and a set per frame. EruptRenderer resets the
+	// section of a frame in BeginFrame, once the fence of the frame that used it last signaled.
+	// Owned by EruptRenderer, see EruptRenderer::GetFrameAllocator. Main thread only
+	class FrameAllocator
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_FRAME_CAPACITY = 4ull << 20;
+
+		FrameAllocator(EruptDevice& device, VkDeviceSize frameCapacity = DEFAULT_FRAME_CAPACITY);
+
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+		// Starts allocating from the section of the frame, everything allocated in it before is discarded
+		void BeginFrame(int frameIndex);
+
+		FrameAllocation Allocate(VkDeviceSize size);
+
+		// Allocates and copies the data in one go
+		template<typename T>
+		FrameAllocation Push(const T& data)
+		{
+			FrameAllocation allocation = Allocate(sizeof(T));
+			std::memcpy(allocation.mapped, &data, sizeof(T));
+			return allocation;
+		}
+
+		inline VkBuffer GetBuffer() const { return m_Buffer->GetBuffer(); }
+		inline VkDeviceSize GetAlignment() const { return m_Alignment; }
+		inline VkDeviceSize GetFrameCapacity() const { return m_FrameCapacity; }
+		inline VkDeviceSize GetFrameUsage() const { return m_Head - m_FrameBegin; }
+
+		// Descriptor for a dynamic binding, each allocation is bound with its dynamic offset
+		VkDescriptorBufferInfo DescriptorInfo(VkDeviceSize range) const;
+
+	private:
+		VkDeviceSize					m_Alignment;
+		VkDeviceSize					m_FrameCapacity;
+		std::unique_ptr<EruptBuffer>	m_Buffer;
+
+		VkDeviceSize					m_FrameBegin = 0;
+		VkDeviceSize					m_Head = 0;
+	};
+}
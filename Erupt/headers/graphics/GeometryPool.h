@@ -0,0 +1,85 @@
+#pragma once
+
+#include "graphics/EruptBuffer.h"
+#include "graphics/UploadQueue.h"
+#include "core/RangeAllocator.h"
+
+#include <memory>
+#include <vector>
+
+namespace Erupt
+{
+	// One device local vertex buffer and one index buffer shared by all models, so a frame binds them once and
+	// models are drawn with their vertex offset and first index. Owned by EruptDevice, see EruptDevice::GetGeometryPool.
+	// Vertex ranges are aligned to their stride and index ranges to 4 bytes, so 16 and 32 bit indices share the index buffer.
+	// Uploads and frees must happen on the main thread outside of command buffer recording: a full buffer grows by
+	// recording a copy into a larger one on the upload queue, the old buffer is destroyed once the copy and the frames
+	// in flight that may still read it are done
+	class GeometryPool
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_VERTEX_CAPACITY = 64ull << 20;
+		static constexpr VkDeviceSize DEFAULT_INDEX_CAPACITY = 32ull << 20;
+
+		GeometryPool(EruptDevice& device, VkDeviceSize vertexCapacity = DEFAULT_VERTEX_CAPACITY, VkDeviceSize indexCapacity = DEFAULT_INDEX_CAPACITY);
+		~GeometryPool();
+
+		GeometryPool(const GeometryPool&) = delete;
+		GeometryPool& operator=(const GeometryPool&) = delete;
+
+		// Record a copy of size bytes at stagingOffset of a staging buffer into a new range and return its byte offset.
+		// The copy is part of the upload queue's current batch, see UploadQueue::GetTicket
+		VkDeviceSize UploadVertices(VkBuffer stagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size, VkDeviceSize stride);
+		VkDeviceSize UploadIndices(VkBuffer stagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size);
+
+		// Ranges are reused once the frames in flight that may still read them are done
+		void FreeVertices(VkDeviceSize offset);
+		void FreeIndices(VkDeviceSize offset);
+
+		// Called by EruptRenderer when a frame starts, after waiting for the frame that used its resources last
+		void NextFrame();
+
+		void BindVertexBuffer(VkCommandBuffer commandBuffer) const;
+		void BindIndexBuffer(VkCommandBuffer commandBuffer, VkIndexType indexType) const;
+
+		inline VkDeviceSize GetVertexCapacity() const { return m_Vertices.allocator.GetSize(); }
+		inline VkDeviceSize GetVertexUsage() const { return m_Vertices.allocator.GetUsed(); }
+		inline VkDeviceSize GetIndexCapacity() const { return m_Indices.allocator.GetSize(); }
+		inline VkDeviceSize GetIndexUsage() const { return m_Indices.allocator.GetUsed(); }
+
+	private:
+		struct PendingFree
+		{
+			VkDeviceSize offset;
+			uint64_t frame;		// last frame that may have read the range
+		};
+
+		struct RetiredBuffer
+		{
+			std::unique_ptr<EruptBuffer> buffer;
+			uint64_t frame;					// last frame that may have read the buffer
+			UploadQueue::Ticket ticket;		// copy into the buffer that replaced it
+		};
+
+		struct Heap
+		{
+			const char* name;
+			VkBufferUsageFlags usage;
+			std::unique_ptr<EruptBuffer> buffer;
+			RangeAllocator allocator;
+			std::vector<PendingFree> pendingFrees;
+			std::vector<RetiredBuffer> retiredBuffers;
+		};
+
+		void CreateHeap(Heap& heap, VkDeviceSize capacity);
+		VkDeviceSize Upload(Heap& heap, VkBuffer stagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size, VkDeviceSize alignment);
+		void ReleasePendingFrees(Heap& heap, uint64_t completedFrame);
+		void ReleaseRetiredBuffers(Heap& heap, uint64_t completedFrame);
+
+	private:
+		EruptDevice&	m_Device;
+		Heap			m_Vertices;
+		Heap			m_Indices;
+		uint64_t		m_Frame = 0;
+	};
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "graphics/Model.h"
+#include "core/FileIO.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace Erupt
+{
+	// Vertex and index arrays of a cooked mesh, pointing into the mapped file so they can be copied straight to staging
+	struct CookedMesh
+	{
+		MappedFile				file;
+		const Model::Vertex*	vertices = nullptr;
+		uint32_t				vertexCount = 0;
+		const uint32_t*			indices = nullptr;
+		uint32_t				indexCount = 0;
+		const Model::Lod*		lods = nullptr;
+		uint32_t				lodCount = 0;
+		const Model::Meshlet*	meshlets = nullptr;
+		uint32_t				meshletCount = 0;
+		Model::Bounds			bounds{};
+
+		CookedMesh(const std::string& filePath) : file(filePath) {}
+	};
+
+	// Cooked binary meshes (.emesh) stored next to their source, e.g. models/vase.obj -> models/vase.emesh:
+	//     MeshHeader (vertex layout, counts, bounds, cook settings and hash of the source file)
+	//     Vertex[vertexCount]
+	//     uint32_t[indexCount]	(all lods back to back)
+	//     Model::Lod[lodCount]
+	//     Model::Meshlet[meshletCount]	(all lods back to back)
+	// A cooked mesh is only used while the hash matches the source, so editing the source re-cooks it on the next load
+	class MeshCache
+	{
+	public:
+		static std::string GetCachePath(const std::string& sourcePath);
+
+		// Hash of the contents of a file in the Resources folder
+		static uint64_t HashSource(const std::string& sourcePath);
+
+		// Maps the cooked mesh of sourcePath. Returns nullptr if there is none, it is invalid, it was cooked from a
+		// source with a different hash or with other settings (optimize, generateLods, buildMeshlets) than settings.
+		// Without a sourceHash any valid cooked mesh is accepted (the source is missing)
+		static std::shared_ptr<CookedMesh> Open(const std::string& sourcePath, std::optional<uint64_t> sourceHash, const Model::Builder& settings);
+
+		// Cooks the vertices, indices, lods and meshlets of builder for sourcePath along with its settings.
+		// Failing to write the file only logs a warning
+		static void Write(const std::string& sourcePath, uint64_t sourceHash, const Model::Builder& builder);
+	};
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <vector>
+
+namespace Erupt
+{
+	// View of one model in its object space: the frustum planes of objectToClip and the camera position.
+	// Testing in object space keeps the normal cones exact under non uniform scale
+	class MeshletCulling
+	{
+	public:
+		// cullBackfaces should match the pipeline, back facing clusters are only invisible if the rasterizer culls them
+		MeshletCulling(const glm::mat4& objectToClip, const glm::vec3& cameraPosition, bool cullBackfaces);
+
+		bool IsSphereVisible(const glm::vec3& center, float radius) const;
+		bool IsMeshletVisible(const Model::Meshlet& meshlet) const;
+
+		// Tests the model bounds and then every meshlet of lod, appending the visible ranges to ranges with neighbouring
+		// meshlets merged into one draw. Returns false if nothing is visible. When lod has no meshlets only the bounds
+		// are tested and ranges is left untouched, draw the whole lod then
+		bool CullModel(const Model& model, uint32_t lod, std::vector<Model::IndexRange>& ranges) const;
+
+	private:
+		glm::vec4	m_Planes[6];
+		glm::vec3	m_CameraPosition;
+		bool		m_CullBackfaces;
+	};
+}
@@ -2,20 +2,33 @@
 
 #include "EruptDevice.h"
 #include "EruptBuffer.h"
+#include "UploadQueue.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace Erupt
 {
+	struct CookedMesh;
+
 	class Model
 	{
 	public:
 
+		// Layout of the vertex buffer on the GPU. Models are always built from Vertex and packed during upload
+		enum class VertexFormat : uint32_t
+		{
+			Full,				// Vertex, 44 bytes
+			PackedHalf,			// PackedVertex with fp16 positions
+			PackedQuantized,	// PackedVertex with unorm16 positions inside the model bounds, decoded by GetPositionDecodeMatrix
+			Count
+		};
+
 		struct Vertex
 		{
 			glm::vec3 position{};
@@ -32,38 +45,180 @@ namespace Erupt
 			}
 		};
 
+		// 20 byte vertex: position (xyz, w unused), octahedral normal (snorm16), color (unorm8, a unused), uv (fp16)
+		struct PackedVertex
+		{
+			uint16_t position[4];
+			int16_t normal[2];
+			uint8_t color[4];
+			uint16_t uv[2];
+
+			static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions();
+			static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions(VertexFormat format);
+		};
+
+		// Range of the index buffer drawing one level of detail
+		struct Lod
+		{
+			uint32_t firstIndex = 0;
+			uint32_t indexCount = 0;
+			float error = 0.f;		// object space deviation from the full resolution mesh
+			uint32_t firstMeshlet = 0;
+			uint32_t meshletCount = 0;	// 0 if the level was not split into meshlets
+		};
+
+		// Cluster of at most 64 vertices and 124 triangles, a contiguous range of the index buffer of its lod.
+		// The bounds are in object space and used to cull clusters on the CPU, see MeshletCulling
+		struct Meshlet
+		{
+			glm::vec3 center{};
+			float radius = 0.f;
+			glm::vec3 coneAxis{};	// average facing of the triangles
+			float coneCutoff = 1.f;	// sine of the spread of the triangle normals around coneAxis, 1 if they face too many ways to cull
+			uint32_t firstIndex = 0;
+			uint32_t indexCount = 0;
+		};
+
+		struct IndexRange
+		{
+			uint32_t firstIndex = 0;
+			uint32_t indexCount = 0;
+		};
+
+		// Levels of detail generated per model, including the full resolution mesh
+		static constexpr uint32_t MAX_LOD_COUNT = 8;
+
+		// Object space axis aligned bounding box
+		struct Bounds
+		{
+			glm::vec3 min{};
+			glm::vec3 max{};
+		};
+
 		struct Builder
 		{
 			std::vector<Vertex> vertices{};
-			std::vector<uint32_t> indices{};
-
+			std::vector<uint32_t> indices{};	// the index ranges of all lods, back to back
+			std::vector<Lod> lods{};			// empty for a single level covering all indices
+			std::vector<Meshlet> meshlets{};	// the meshlets of all lods, back to back
+			std::string filepath{};		// empty for models that were not loaded from a file
+			Bounds bounds{};			// required by VertexFormat::PackedQuantized, see ComputeBounds
+			VertexFormat format = VertexFormat::Full;
+			bool optimize = true;		// reorder parsed meshes for the vertex cache, overdraw and vertex fetch, see Optimize
+			bool generateLods = true;	// simplify parsed meshes into a lod chain, see GenerateLods
+			bool buildMeshlets = true;	// split every lod into meshlets for cluster culling, see BuildMeshlets
+
+			// Set instead of vertices and indices when the model was loaded from an up to date cooked mesh
+			std::shared_ptr<CookedMesh> cooked{};
+
+			// Loads the cooked mesh of filepath, parsing and cooking the source first if the cache is missing or stale
 			void LoadModel(const std::string& filepath);
+			void ComputeBounds();
+
+			// Runs the MeshOptimizer passes on vertices and indices and logs the cache efficiency before and after
+			void Optimize();
+
+			// Appends levels of detail with half the triangles of the previous level each, until MAX_LOD_COUNT levels exist
+			// or the mesh stops simplifying. Every level is optimized for the vertex cache
+			void GenerateLods();
+
+			// Splits the index range of every lod into meshlets, keeping the triangle order
+			void BuildMeshlets();
+
+			// Data to upload, taken from the cooked mesh when there is one
+			const Vertex* GetVertexData() const;
+			uint32_t GetVertexCount() const;
+			const uint32_t* GetIndexData() const;
+			uint32_t GetIndexCount() const;
+			const Lod* GetLodData() const;
+			uint32_t GetLodCount() const;
+			const Meshlet* GetMeshletData() const;
+			uint32_t GetMeshletCount() const;
+
+		private:
+			void LoadObj(const std::string& filepath);
 		};
 
+		// Uploads the builder's geometry before returning, see ModelLoader for loading in the background
 		Model(EruptDevice& device, const Builder& builder);
 		~Model();
 
 		Model(const Model&) = delete;
 		Model& operator=(const Model&) = delete;
 
-		static std::unique_ptr<Model> CreateModelFromFile(EruptDevice& device, const std::string& filepath);
+		static std::unique_ptr<Model> CreateModelFromFile(EruptDevice& device, const std::string& filepath, VertexFormat format = VertexFormat::Full);
+
+		// Parses all files in parallel on the job system, the GPU buffers are then created on the calling thread.
+		// formats holds the vertex format of every file, all models use VertexFormat::Full when it is empty
+		static std::vector<std::unique_ptr<Model>> CreateModelsFromFiles(EruptDevice& device, const std::vector<std::string>& filepaths, const std::vector<VertexFormat>& formats = {});
+
+		// Vertex input state of pipelines drawing models of the given format
+		static std::vector<VkVertexInputBindingDescription> GetBindingDescriptions(VertexFormat format);
+		static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions(VertexFormat format);
+
+		// False while a ModelLoader is still loading the model or its upload did not execute yet, and forever if loading
+		// failed. Only the file path and vertex format are valid until the upload was recorded, and the model must not be drawn
+		bool IsReady() const;
 
+		// Resources relative path the model was loaded from, empty for procedural models
+		inline const std::string& GetFilePath() const { return m_FilePath; }
+		inline const Bounds& GetBounds() const { return m_Bounds; }
+		inline VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+		inline bool IsIndexed() const { return m_IsIndexed; }
+		inline VkIndexType GetIndexType() const { return m_IndexType; }
+
+		// Levels of detail from full resolution to coarsest, with increasing error
+		inline const std::vector<Lod>& GetLods() const { return m_Lods; }
+		inline const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+
+		// Bytes held in system memory and in the geometry pool, 0 on the GPU until the model is uploaded
+		size_t GetCpuMemoryUsage() const;
+		size_t GetGpuMemoryUsage() const;
+
+		// Object space transform of the positions read by the vertex shader, multiply it into the model matrix
+		inline const glm::mat4& GetPositionDecodeMatrix() const { return m_PositionDecodeMatrix; }
+
+		// Binds the geometry pool buffers. Draws of models sharing the index type only need the pool bound once
 		void Bind(VkCommandBuffer commandBuffer);
-		void Draw(VkCommandBuffer commandBuffer);
+		void Draw(VkCommandBuffer commandBuffer, uint32_t lod = 0);
+
+		// Draws part of the index buffer, e.g. the visible meshlets of a lod. Only valid for indexed models
+		void DrawRange(VkCommandBuffer commandBuffer, const IndexRange& range);
 
 	private:
-		void CreateVertexBuffers(const std::vector<Vertex>& vertices);
-		void CreateIndexBuffers(const std::vector<uint32_t>& indices);
+		friend class ModelLoader;
+
+		// Model that is not ready until Upload is called
+		Model(EruptDevice& device, const std::string& filepath, VertexFormat format);
+
+		// Records the copies into the upload queue, the model is ready once their batch executed
+		void Upload(const Builder& builder);
+
+		void CreateVertexBuffers(const Vertex* vertices, uint32_t vertexCount);
+		void CreateIndexBuffers(const uint32_t* indices, uint32_t indexCount);
+		void CreateLods(const Lod* lods, uint32_t lodCount);
+		void CreateMeshlets(const Meshlet* meshlets, uint32_t meshletCount);
 
 	private:
 		EruptDevice& m_Device;
+		UploadQueue::Ticket m_UploadTicket = 0;
+		std::string m_FilePath;
+		Bounds m_Bounds;
+		VertexFormat m_VertexFormat;
+		glm::mat4 m_PositionDecodeMatrix;
 
-		std::unique_ptr<EruptBuffer> m_VertexBuffer;
-		uint32_t m_VertexCount;
+		// Ranges of the geometry pool buffers, as byte offsets and as the vertex offset and first index of draws
+		VkDeviceSize m_VertexBufferOffset = 0;
+		int32_t m_VertexOffset = 0;
+		uint32_t m_VertexCount = 0;
 
 		bool m_IsIndexed = false;
-		std::unique_ptr<EruptBuffer> m_IndexBuffer;
-		uint32_t m_IndexCount;
+		VkDeviceSize m_IndexBufferOffset = 0;
+		uint32_t m_FirstIndex = 0;
+		uint32_t m_IndexCount = 0;
+		std::vector<Lod> m_Lods;
+		std::vector<Meshlet> m_Meshlets;
+		VkIndexType m_IndexType = VK_INDEX_TYPE_UINT32;
 	};
 
 }
\ No newline at end of file
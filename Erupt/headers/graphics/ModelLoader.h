@@ -0,0 +1,59 @@
+#pragma once
+
+#include "graphics/Model.h"
+#include "core/JobSystem.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Erupt
+{
+	// Loads models in the background while frames keep rendering. LoadAsync returns a model that is not ready yet,
+	// its file is parsed on the job system and Update records its upload into the device's UploadQueue, which submits
+	// the uploads of all models parsed in a frame together.
+	// Render systems skip models until Model::IsReady. Everything but the parsing runs on the main thread
+	class ModelLoader
+	{
+	public:
+		// Runs on the main thread once the model is ready, or once loading it failed and it never will be
+		using Callback = std::function<void(const std::shared_ptr<Model>& model)>;
+
+		ModelLoader(EruptDevice& device);
+		~ModelLoader();
+
+		ModelLoader(const ModelLoader&) = delete;
+		ModelLoader& operator=(const ModelLoader&) = delete;
+
+		std::shared_ptr<Model> LoadAsync(const std::string& filepath, Model::VertexFormat format = Model::VertexFormat::Full, Callback onLoaded = {});
+
+		// Starts uploading parsed models and finishes the uploads that completed. Call once per frame,
+		// outside of command buffer recording
+		void Update();
+
+		// Blocks until every load finished. Has to run before the job system shuts down
+		void WaitIdle();
+
+		inline size_t GetPendingCount() const { return m_Loads.size(); }
+
+	private:
+		struct PendingLoad
+		{
+			std::shared_ptr<Model> model;
+			Callback onLoaded;
+
+			Model::Builder builder;
+			JobCounter parsed;
+
+			bool uploaded = false;
+		};
+
+		// Returns true once the load is finished and can be removed
+		bool Advance(PendingLoad& load, bool wait);
+
+	private:
+		EruptDevice&								m_Device;
+		std::vector<std::unique_ptr<PendingLoad>>	m_Loads;
+	};
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "graphics/EruptBuffer.h"
+
+#include <deque>
+#include <memory>
+
+namespace Erupt
+{
+	class StagingRing;
+
+	// Host visible memory to copy from, handed back to the ring when destroyed. Destroy it once the copies reading it
+	// executed: right after a synchronous copy, or once the fence of the submission signaled
+	class StagingRegion
+	{
+	public:
+		StagingRegion() = default;
+		~StagingRegion();
+
+		StagingRegion(StagingRegion&& other) noexcept;
+		StagingRegion& operator=(StagingRegion&& other) noexcept;
+
+		StagingRegion(const StagingRegion&) = delete;
+		StagingRegion& operator=(const StagingRegion&) = delete;
+
+		inline VkBuffer GetBuffer() const { return m_Buffer; }
+		inline VkDeviceSize GetOffset() const { return m_Offset; }
+		inline VkDeviceSize GetSize() const { return m_Size; }
+		inline void* GetMappedMemory() const { return m_Mapped; }
+
+		// Whether the ring was full or the upload too large, and a temporary buffer was created instead
+		inline bool IsTemporary() const { return m_TemporaryBuffer != nullptr; }
+
+	private:
+		friend class StagingRing;
+
+		StagingRing* m_Ring = nullptr;
+		uint64_t m_Begin = 0;		// position in the ring, including the padding in front of the region
+
+		VkBuffer m_Buffer = VK_NULL_HANDLE;
+		VkDeviceSize m_Offset = 0;
+		VkDeviceSize m_Size = 0;
+		void* m_Mapped = nullptr;
+
+		std::unique_ptr<EruptBuffer> m_TemporaryBuffer;
+	};
+
+	// One persistently mapped staging buffer that uploads are written into back to back, so uploading does not create
+	// and destroy a buffer every time. Space is reused in allocation order once the regions in front were handed back,
+	// wrapping around at the end of the buffer. A region that does not fit, because it is larger than half the ring or
+	// earlier uploads are still in flight, gets a temporary buffer. Owned by EruptDevice, see EruptDevice::GetStagingRing.
+	// Main thread only, like the geometry pool it feeds
+	class StagingRing
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_ALIGNMENT = 16;
+
+		struct Statistics
+		{
+			uint64_t ringAllocations = 0;
+			uint64_t temporaryAllocations = 0;
+			VkDeviceSize inFlightBytes = 0;		// ring space that was not handed back yet, including padding
+		};
+
+		// The capacity is configured through EruptDevice, see EruptDevice::DEFAULT_STAGING_CAPACITY
+		StagingRing(EruptDevice& device, VkDeviceSize capacity);
+		~StagingRing();
+
+		StagingRing(const StagingRing&) = delete;
+		StagingRing& operator=(const StagingRing&) = delete;
+
+		StagingRegion Allocate(VkDeviceSize size, VkDeviceSize alignment = DEFAULT_ALIGNMENT);
+
+		inline VkDeviceSize GetCapacity() const { return m_Capacity; }
+		Statistics GetStatistics() const;
+
+	private:
+		friend class StagingRegion;
+
+		struct Region
+		{
+			uint64_t begin;
+			uint64_t end;
+			bool released;
+		};
+
+		void Release(uint64_t begin);
+		void Retire();
+
+	private:
+		EruptDevice&					m_Device;
+		VkDeviceSize					m_Capacity;
+		std::unique_ptr<EruptBuffer>	m_Buffer;
+
+		// Positions grow forever, the offset into the buffer is the position modulo the capacity
+		uint64_t						m_Head = 0;
+		uint64_t						m_Tail = 0;
+		std::deque<Region>				m_Regions;
+
+		uint64_t						m_RingAllocations = 0;
+		uint64_t						m_TemporaryAllocations = 0;
+	};
+}
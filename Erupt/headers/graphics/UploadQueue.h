@@ -0,0 +1,109 @@
+#pragma once
+
+#include "graphics/StagingRing.h"
+
+#include <deque>
+#include <vector>
+
+namespace Erupt
+{
+	// Collects the copies of a frame into one command buffer instead of submitting and waiting for each of them.
+	// EruptRenderer submits the batch once per frame, ahead of the frame that may read it, with a fence that is
+	// polled instead of waited for. Copies get the ticket of their batch, IsComplete tells when their data is resident.
+	//
+	// On devices with a transfer queue family (see QueueFamilyIndices::transferFamily) the copies run on that queue and
+	// overlap with rendering. Every written range is released to the graphics family at the end of the batch, and a
+	// small graphics queue submission waits for the batch's semaphore and acquires the ranges before later frames read
+	// them. Without such a family the batch runs on the graphics queue and ends with a plain barrier.
+	// Owned by EruptDevice, see EruptDevice::GetUploadQueue. Main thread only
+	class UploadQueue
+	{
+	public:
+		// Batches complete in submission order, so a ticket also completes every ticket below it
+		using Ticket = uint64_t;
+
+		UploadQueue(EruptDevice& device);
+		~UploadQueue();
+
+		UploadQueue(const UploadQueue&) = delete;
+		UploadQueue& operator=(const UploadQueue&) = delete;
+
+		Ticket CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
+
+		// The image has to be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL and stays in it
+		Ticket CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount, VkDeviceSize bufferOffset = 0);
+
+		// Copies data that earlier copies uploaded, like the geometry pool moving into a larger buffer. Runs after every copy
+		// recorded before it and before every copy recorded after it. On a transfer queue the uploaded data belongs to the
+		// graphics family, so the copy runs in the graphics queue submission of the batch and the batch is submitted right away
+		Ticket CopyUploadedBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
+
+		// Keeps a staging region alive until the batch being recorded executed
+		void Retain(StagingRegion&& region);
+
+		// Ticket that completes once everything recorded so far executed
+		Ticket GetTicket() const;
+		bool IsComplete(Ticket ticket) const { return ticket <= m_CompletedTicket; }
+
+		// Whether copies run on a transfer queue instead of the graphics queue
+		inline bool IsDedicated() const { return m_TransferFamily != m_GraphicsFamily; }
+
+		// Submits the batch being recorded, if anything was recorded
+		void Submit();
+
+		// Submits the batch being recorded and retires the batches that executed. Called by EruptRenderer once per frame
+		void Update();
+
+		// Blocks until the ticket completed, submitting it first if needed
+		void Wait(Ticket ticket);
+		void WaitIdle() { Wait(GetTicket()); }
+
+	private:
+		struct UploadedCopy
+		{
+			VkBuffer srcBuffer;
+			VkBuffer dstBuffer;
+			VkBufferCopy region;
+		};
+
+		struct Batch
+		{
+			Ticket ticket = 0;
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			VkFence fence = VK_NULL_HANDLE;
+			std::vector<StagingRegion> stagingRegions;
+
+			// Queue family ownership transfers, only on a transfer queue
+			std::vector<VkBufferMemoryBarrier> bufferTransfers;
+			std::vector<VkImageMemoryBarrier> imageTransfers;
+			VkCommandBuffer acquireCommandBuffer = VK_NULL_HANDLE;
+			VkSemaphore transferred = VK_NULL_HANDLE;
+
+			// Copies of uploaded data after the acquire, the next batch's copies wait for them through the copied semaphore
+			std::vector<UploadedCopy> uploadedCopies;
+			VkSemaphore copied = VK_NULL_HANDLE;
+			VkSemaphore waited = VK_NULL_HANDLE;	// copied semaphore of an earlier batch, destroyed with this batch
+		};
+
+		VkCommandBuffer GetCommandBuffer();
+		VkCommandBuffer BeginCommandBuffer(VkCommandPool commandPool);
+		void SubmitCommandBuffer(VkQueue queue, VkCommandBuffer commandBuffer, VkSemaphore waitSemaphore, VkPipelineStageFlags waitStages, VkSemaphore signalSemaphore, VkFence fence);
+		VkSemaphore CreateBatchSemaphore();
+		void Retire(Batch& batch);
+
+	private:
+		EruptDevice&		m_Device;
+
+		uint32_t			m_GraphicsFamily;
+		uint32_t			m_TransferFamily;
+		VkQueue				m_TransferQueue;
+		VkCommandPool		m_CommandPool = VK_NULL_HANDLE;				// transfer family, graphics family without one
+		VkCommandPool		m_AcquireCommandPool = VK_NULL_HANDLE;		// graphics family, only on a transfer queue
+
+		Batch				m_Recording;
+		std::deque<Batch>	m_InFlight;
+		VkSemaphore			m_CopiedSemaphore = VK_NULL_HANDLE;		// signaled by uploaded copies no transfer submission waited for yet
+
+		Ticket				m_CompletedTicket = 0;
+	};
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Erupt
+{
+	// Post transform vertex cache efficiency of an index buffer, simulated with a FIFO cache
+	struct VertexCacheStatistics
+	{
+		float acmr = 0.f;	// average cache miss ratio, transformed vertices per triangle (0.5 is the best case for large grids, 3 the worst)
+		float atvr = 0.f;	// average transformed to vertex ratio, transformed vertices per vertex (1 is optimal)
+	};
+
+	// Reorders indexed triangle lists for the GPU after welding:
+	//     OptimizeVertexCache  - Tipsify (Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw")
+	//     OptimizeOverdraw     - splits the result into clusters and sorts them so outward facing clusters are drawn first
+	//     OptimizeVertexFetch  - renumbers vertices in first use order so the vertex buffer is read linearly
+	// All passes keep the winding of every triangle and run in linear time
+	class MeshOptimizer
+	{
+	public:
+		// Entries of the simulated FIFO cache, a conservative size for current GPUs
+		static constexpr uint32_t CACHE_SIZE = 16;
+
+		// Clusters may be at most this much worse than their Tipsify island, trading cache hits for overdraw
+		static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+		static VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+		// Writes the reordered triangles to destination, which must not alias indices
+		static void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+		// Expects indices that went through OptimizeVertexCache with the same cacheSize
+		static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Model::Vertex>& vertices, float threshold = OVERDRAW_THRESHOLD, uint32_t cacheSize = CACHE_SIZE);
+
+		// Drops vertices that are not referenced by any triangle
+		static void OptimizeVertexFetch(std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices);
+	};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Erupt
+{
+	// Quadric error metric edge collapse (Garland and Heckbert 1997, "Surface Simplification Using Quadric Error Metrics").
+	// Vertices collapse onto one of their neighbours, so the simplified index buffer shares the vertex buffer of the input.
+	// Vertices on borders, non manifold edges and attribute seams (several vertices at one position) never move, which keeps
+	// meshes closed and their uv/normal seams intact at the cost of simplifying such regions less
+	class MeshSimplifier
+	{
+	public:
+		// Collapses the cheapest edges of the triangle list indices until at most targetIndexCount indices are left or
+		// nothing can collapse below maxError. Returns the reached error: the RMS distance, in object space units, of the
+		// moved vertices to the planes of the triangles they replaced
+		static float Simplify(std::vector<uint32_t>& destination, const uint32_t* indices, size_t indexCount, const std::vector<Model::Vertex>& vertices,
+			size_t targetIndexCount, float maxError);
+	};
+}
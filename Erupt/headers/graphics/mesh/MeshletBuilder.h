@@ -0,0 +1,28 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Erupt
+{
+	// Splits triangle lists into meshlets by scanning them in order and starting a new meshlet whenever the vertex or
+	// triangle limit would be exceeded. Meshes that went through MeshOptimizer are ordered for vertex locality,
+	// so the scan yields compact clusters while keeping every meshlet a contiguous range of the index buffer
+	class MeshletBuilder
+	{
+	public:
+		// Sized for mesh shader friendly clusters (NVIDIA's recommended 64 vertices and 126 triangles, rounded down to
+		// a multiple of four)
+		static constexpr uint32_t MAX_VERTICES = 64;
+		static constexpr uint32_t MAX_TRIANGLES = 124;
+
+		// Appends the meshlets of indices[firstIndex, firstIndex + indexCount) to meshlets
+		static void Build(const std::vector<uint32_t>& indices, uint32_t firstIndex, uint32_t indexCount, const std::vector<Model::Vertex>& vertices, std::vector<Model::Meshlet>& meshlets);
+
+		// Bounding sphere and normal cone of the triangles of meshlet
+		static void ComputeBounds(Model::Meshlet& meshlet, const std::vector<uint32_t>& indices, const std::vector<Model::Vertex>& vertices);
+	};
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Erupt
+{
+	// Multithreaded Wavefront OBJ reader. The mapped file is split at line boundaries and parsed in three passes on the job system:
+	// count the attributes of every chunk, parse the chunks straight into the shared attribute arrays at their offsets,
+	// then resolve and triangulate the faces. Numbers, relative indices, default vertex colors and the quad split follow
+	// tinyobj exactly, so the corner stream is identical to the one built from tinyobj's output
+	class ObjParser
+	{
+	public:
+		// Files are split into chunks of at least this size
+		static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+		// Fills corners with one vertex per triangle corner in file order. Throws on malformed faces.
+		// Returns false without touching corners if the file needs tinyobj: polygons with more than four corners
+		// (ear clipping) or quads referencing vertices that are defined after them
+		static bool Parse(const std::string& filePath, std::vector<Model::Vertex>& corners);
+	};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <cstddef>
+
+namespace Erupt
+{
+	// Conversion of Model::Vertex into the packed GPU formats, the matching decode lives in simple_shader_packed.vert
+	class VertexPacking
+	{
+	public:
+		// Writes count packed vertices to out, e.g. straight into a mapped staging buffer
+		static void Pack(const Model::Vertex* vertices, size_t count, Model::VertexFormat format, const Model::Bounds& bounds, Model::PackedVertex* out);
+
+		// Maps what the shader reads as position back to object space: identity, or the bounds box for quantized positions
+		static glm::mat4 GetPositionDecodeMatrix(Model::VertexFormat format, const Model::Bounds& bounds);
+
+		// Unit vector to the [-1, 1] square (Cigolle et al. 2014, "A Survey of Efficient Representations for Independent Unit Vectors")
+		static glm::vec2 OctahedralEncode(const glm::vec3& normal);
+		static glm::vec3 OctahedralDecode(const glm::vec2& encoded);
+	};
+}
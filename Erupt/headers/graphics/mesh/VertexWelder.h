@@ -0,0 +1,29 @@
+#pragma once
+
+#include "graphics/Model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Erupt
+{
+	// Turns a vertex stream (one vertex per triangle corner) into unique vertices and an index buffer.
+	// Every vertex is hashed once over its raw bytes and looked up in a flat open addressing table.
+	// Unique vertices keep the order of their first occurrence, so the serial and parallel paths produce identical output.
+	// With an epsilon above zero all attributes are snapped to a grid of that size before comparing, which also welds
+	// vertices that only differ by noise. Like any grid snap it can miss two close values on either side of a cell border
+	class VertexWelder
+	{
+	public:
+		// Streams of at least this many vertices are welded in parallel when the job system has workers
+		static constexpr size_t PARALLEL_THRESHOLD = 1 << 18;
+
+		static void Weld(const Model::Vertex* stream, size_t count, std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon = 0.f);
+
+		static void WeldSerial(const Model::Vertex* stream, size_t count, std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon = 0.f);
+
+		// Shards the stream by hash, welds every shard in its own job and restores the first occurrence order afterwards
+		static void WeldParallel(const Model::Vertex* stream, size_t count, std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon = 0.f);
+	};
+}
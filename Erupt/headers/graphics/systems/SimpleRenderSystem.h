@@ -2,10 +2,13 @@
 
 #include "graphics/EruptPipeline.h"
 #include "graphics/EruptFrameInfo.h"
+#include "graphics/Model.h"
 
 #include "ECS/Entity.h"
 #include "core/Camera.h"
 
+#include <array>
+
 namespace Erupt
 {
 	class SimpleRenderSystem
@@ -25,8 +28,12 @@ namespace Erupt
 	private:
 		EruptDevice&					m_EruptDevice;
 
-		std::unique_ptr<EruptPipeline>	m_EruptPipeline;
+		// One pipeline per vertex format, indexed by VertexFormat
+		std::array<std::unique_ptr<EruptPipeline>, static_cast<size_t>(Model::VertexFormat::Count)>	m_EruptPipelines;
 		VkPipelineLayout				m_PipelineLayout;
+
+		bool							m_CullBackfaces = false;
+		std::vector<Model::IndexRange>	m_VisibleRanges;	// reused between entities
 	};
 
 } // namespace Erupt
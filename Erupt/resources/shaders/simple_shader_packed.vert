@@ -0,0 +1,58 @@
+#version 450
+
+// Model::PackedVertex, quantized positions are decoded by the model matrix
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec2 packedNormal;
+layout(location = 3) in vec2 uv;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragPosWorld;
+layout(location = 2) out vec3 fragNormalWorld;
+
+struct PointLight
+{
+	vec4 position; // ignore w
+	vec4 color; // w is intensity
+};
+
+layout(set = 0, binding = 0) uniform GlobalUbo
+{
+	mat4 projection;
+	mat4 view;
+	vec4 ambientLightColor; // w is intensity
+	PointLight pointLights[10];
+	int numLights;
+} ubo;
+
+layout(push_constant) uniform Push
+{
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+} push;
+
+vec3 OctahedralDecode(vec2 e)
+{
+	vec3 v = vec3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+	if (v.z < 0.0f)
+	{
+		v.xy = (1.0f - abs(v.yx)) * vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+	}
+	return normalize(v);
+}
+
+void main()
+{
+	vec3 normal = OctahedralDecode(packedNormal);
+	vec4 worldPosition = push.modelMatrix * vec4(position.xyz, 1.0f);
+
+	gl_Position = ubo.projection * ubo.view * worldPosition;
+
+	// This works only when the model is scaled uniformly (possible work-around: allow only for uniform scaling)
+	//mat3 normalMatrix = transpose(inverse(mat3(push.modelMatrix)));
+	//vec3 normalWorldSpace = normalize(normalMatrix * normal);
+
+	fragNormalWorld = normalize(mat3(push.normalMatrix) * normal);
+	fragPosWorld = worldPosition.xyz;
+	fragColor = color.rgb;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "ECS/Archetype.h"
+
+namespace Erupt
+{
+	Archetype::Archetype(const ComponentMask& mask)
+		: m_Mask(mask)
+	{
+	}
+
+	std::unique_ptr<Archetype> Archetype::Create(const ComponentMask& mask)
+	{
+		auto archetype = std::make_unique<Archetype>(mask);
+
+		for (size_t i = 0; i < MAX_COMPONENTS; i++)
+		{
+			if (mask.test(i))
+			{
+				archetype->m_Columns[i] = ComponentType::CreateColumn(static_cast<ComponentTypeId>(i));
+			}
+		}
+
+		return archetype;
+	}
+
+	std::unique_ptr<Archetype> Archetype::CreateFrom(const Archetype& source, const ComponentMask& mask, std::unique_ptr<IComponentColumn> extraColumn, ComponentTypeId extraType)
+	{
+		auto archetype = std::make_unique<Archetype>(mask);
+
+		for (size_t i = 0; i < MAX_COMPONENTS; i++)
+		{
+			if (mask.test(i) && source.m_Columns[i] != nullptr)
+			{
+				archetype->m_Columns[i] = source.m_Columns[i]->CreateEmpty();
+			}
+		}
+
+		if (extraColumn != nullptr)
+		{
+			assert(mask.test(extraType) && "Extra column is not part of the archetype mask");
+			archetype->m_Columns[extraType] = std::move(extraColumn);
+		}
+
+		return archetype;
+	}
+
+	size_t Archetype::MoveRowFrom(Archetype& source, size_t row)
+	{
+		assert(row < source.Size() && "Row out of range");
+
+		for (size_t i = 0; i < MAX_COMPONENTS; i++)
+		{
+			if (m_Columns[i] != nullptr && source.m_Columns[i] != nullptr)
+			{
+				m_Columns[i]->MoveFrom(*source.m_Columns[i], row);
+			}
+		}
+
+		m_Entities.push_back(source.m_Entities[row]);
+		return m_Entities.size() - 1;
+	}
+
+	size_t Archetype::PushEntity(Entity entity)
+	{
+		assert(m_Mask.none() && "Entities can only be pushed directly into the empty archetype");
+
+		m_Entities.push_back(entity);
+		return m_Entities.size() - 1;
+	}
+
+	size_t Archetype::AppendRows(const Entity* entities, size_t count)
+	{
+		const size_t firstRow = m_Entities.size();
+
+		for (auto& column : m_Columns)
+		{
+			if (column != nullptr)
+			{
+				column->Resize(firstRow + count);
+			}
+		}
+
+		m_Entities.insert(m_Entities.end(), entities, entities + count);
+		return firstRow;
+	}
+
+	Entity Archetype::SwapRemove(size_t row)
+	{
+		assert(row < Size() && "Row out of range");
+
+		for (auto& column : m_Columns)
+		{
+			if (column != nullptr)
+			{
+				column->SwapRemove(row);
+			}
+		}
+
+		const bool isLast = row == m_Entities.size() - 1;
+		if (!isLast)
+		{
+			m_Entities[row] = m_Entities.back();
+		}
+		m_Entities.pop_back();
+
+		return isLast ? Entity{} : m_Entities[row];
+	}
+}
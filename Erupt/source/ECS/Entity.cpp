@@ -1,78 +1,75 @@
 #include "ECS/Entity.h"
+#include "ECS/Registry.h"
 
 namespace Erupt
 {
-	glm::mat4 TransformComponent::mat4()
+	namespace
 	{
-		const float c3 = glm::cos(rotation.z);
-		const float s3 = glm::sin(rotation.z);
-		const float c2 = glm::cos(rotation.x);
-		const float s2 = glm::sin(rotation.x);
-		const float c1 = glm::cos(rotation.y);
-		const float s1 = glm::sin(rotation.y);
-
-		return glm::mat4
+		// Blends the basis columns and restores their interpolated length, which keeps rotations from shrinking the matrix
+		template<typename Matrix>
+		Matrix BlendBasis(const Matrix& previous, const Matrix& current, float alpha)
 		{
+			Matrix result = current;
+			for (int column = 0; column < 3; column++)
 			{
-				scale.x * (c1 * c3 + s1 * s2 * s3),
-				scale.x * (c2 * s3),
-				scale.x * (c1 * s2 * s3 - c3 * s1),
-				0.0f,
-			},
-			{
-				scale.y * (c3 * s1 * s2 - c1 * s3),
-				scale.y * (c2 * c3),
-				scale.y * (c1 * c3 * s2 + s1 * s3),
-				0.0f,
-			},
-			{
-				scale.z * (c2 * s1),
-				scale.z * (-s2),
-				scale.z * (c1 * c2),
-				0.0f,
-			},
-			{translation.x, translation.y, translation.z, 1.0f}
-		};
+				const glm::vec3 previousColumn = glm::vec3(previous[column]);
+				const glm::vec3 currentColumn = glm::vec3(current[column]);
+				const glm::vec3 blended = glm::mix(previousColumn, currentColumn, alpha);
+
+				const float length = glm::mix(glm::length(previousColumn), glm::length(currentColumn), alpha);
+				const float blendedLength = glm::length(blended);
+				const glm::vec3 column3 = blendedLength > 0.f ? blended * (length / blendedLength) : blended;
+
+				for (int row = 0; row < 3; row++)
+				{
+					result[column][row] = column3[row];
+				}
+			}
+			return result;
+		}
 	}
 
-	glm::mat3 TransformComponent::normalMatrix()
+	glm::mat4 TransformComponent::GetInterpolatedWorldMatrix(float alpha) const
 	{
-		const float c3 = glm::cos(rotation.z);
-		const float s3 = glm::sin(rotation.z);
-		const float c2 = glm::cos(rotation.x);
-		const float s2 = glm::sin(rotation.x);
-		const float c1 = glm::cos(rotation.y);
-		const float s1 = glm::sin(rotation.y);
+		if (!m_Interpolate)
+		{
+			return m_WorldMatrix;
+		}
 
-		const glm::vec3 inverseScale = 1.0f / scale;
+		glm::mat4 result = BlendBasis(m_PreviousWorldMatrix, m_WorldMatrix, alpha);
+		result[3] = glm::mix(m_PreviousWorldMatrix[3], m_WorldMatrix[3], alpha);
+		return result;
+	}
 
-		return glm::mat3
+	glm::mat3 TransformComponent::GetInterpolatedWorldNormalMatrix(float alpha) const
+	{
+		if (!m_Interpolate)
 		{
-			{
-				inverseScale.x * (c1 * c3 + s1 * s2 * s3),
-				inverseScale.x * (c2 * s3),
-				inverseScale.x * (c1 * s2 * s3 - c3 * s1),
-			},
-			{
-				inverseScale.y * (c3 * s1 * s2 - c1 * s3),
-				inverseScale.y * (c2 * c3),
-				inverseScale.y * (c1 * c3 * s2 + s1 * s3),
-			},
-			{
-				inverseScale.z * (c2 * s1),
-				inverseScale.z * (-s2),
-				inverseScale.z * (c1 * c2),
-			},
-		};
+			return m_WorldNormalMatrix;
+		}
+
+		return BlendBasis(m_PreviousWorldNormalMatrix, m_WorldNormalMatrix, alpha);
 	}
 
-	Entity Entity::MakePointLight(float intensity, float radius, glm::vec3 color)
+	glm::vec3 TransformComponent::GetInterpolatedWorldTranslation(float alpha) const
 	{
-		Entity entity = CreateEntity();
-		entity.m_Color = color;
-		entity.m_Transform.scale.x = radius;
-		entity.pointLight = std::make_unique<PointLightComponent>();
-		entity.pointLight->lightIntensity = intensity;
+		if (!m_Interpolate)
+		{
+			return GetWorldTranslation();
+		}
+
+		return glm::mix(glm::vec3(m_PreviousWorldMatrix[3]), glm::vec3(m_WorldMatrix[3]), alpha);
+	}
+
+	Entity Entity::MakePointLight(Registry& registry, float intensity, float radius, glm::vec3 color)
+	{
+		Entity entity = registry.CreateEntity();
+
+		auto& transform = registry.AddComponent<TransformComponent>(entity);
+		transform.SetScale({ radius, 1.f, 1.f });
+
+		registry.AddComponent<ColorComponent>(entity, color);
+		registry.AddComponent<PointLightComponent>(entity, intensity);
 
 		return entity;
 	}
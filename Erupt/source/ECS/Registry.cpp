@@ -0,0 +1,189 @@
+#include "ECS/Registry.h"
+
+#include "core/Log.h"
+
+#include <stdexcept>
+
+namespace Erupt
+{
+	Registry::Registry()
+	{
+		auto emptyArchetype = std::make_unique<Archetype>(ComponentMask{});
+		m_EmptyArchetype = emptyArchetype.get();
+
+		m_ArchetypeLookup.emplace(ComponentMask{}, m_EmptyArchetype);
+		m_Archetypes.push_back(std::move(emptyArchetype));
+	}
+
+	Registry::~Registry()
+	{
+	}
+
+	Entity::index_t Registry::AllocateSlot()
+	{
+		Entity::index_t index;
+		if (m_FreeListHead != Entity::INVALID_INDEX)
+		{
+			index = m_FreeListHead;
+			m_FreeListHead = m_Slots[index].nextFree;
+		}
+		else
+		{
+			index = static_cast<Entity::index_t>(m_Slots.size());
+			m_Slots.emplace_back();
+		}
+		return index;
+	}
+
+	Entity Registry::CreateEntity()
+	{
+		const Entity::index_t index = AllocateSlot();
+
+		EntitySlot& slot = m_Slots[index];
+		Entity entity{ index, slot.generation };
+
+		slot.archetype = m_EmptyArchetype;
+		slot.row = m_EmptyArchetype->PushEntity(entity);
+		slot.nextFree = Entity::INVALID_INDEX;
+
+		m_AliveCount++;
+		return entity;
+	}
+
+	Archetype& Registry::CreateEntities(const ComponentMask& mask, size_t count, Entity* entities, size_t& firstRow)
+	{
+		Archetype& archetype = *GetOrCreateArchetype(mask);
+
+		m_Slots.reserve(m_Slots.size() + count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const Entity::index_t index = AllocateSlot();
+			entities[i] = Entity{ index, m_Slots[index].generation };
+		}
+
+		firstRow = archetype.AppendRows(entities, count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			EntitySlot& slot = m_Slots[entities[i].GetIndex()];
+			slot.archetype = &archetype;
+			slot.row = firstRow + i;
+			slot.nextFree = Entity::INVALID_INDEX;
+		}
+
+		m_AliveCount += count;
+		return archetype;
+	}
+
+	void Registry::DestroyEntity(Entity entity)
+	{
+		EntitySlot& slot = GetSlot(entity);
+
+		Entity moved = slot.archetype->SwapRemove(slot.row);
+		if (moved.IsValid())
+		{
+			m_Slots[moved.GetIndex()].row = slot.row;
+		}
+
+		// Bumping the generation invalidates every outstanding handle to this slot
+		slot.archetype = nullptr;
+		slot.generation++;
+		slot.nextFree = m_FreeListHead;
+		m_FreeListHead = entity.GetIndex();
+
+		m_AliveCount--;
+	}
+
+	bool Registry::IsValid(Entity entity) const
+	{
+		if (entity.GetIndex() >= m_Slots.size())
+		{
+			return false;
+		}
+
+		const EntitySlot& slot = m_Slots[entity.GetIndex()];
+		return slot.archetype != nullptr && slot.generation == entity.GetGeneration();
+	}
+
+	Registry::EntitySlot& Registry::GetSlot(Entity entity)
+	{
+		if (!IsValid(entity))
+		{
+			ERUPT_CORE_ERROR("Entity {0} (generation {1}) does not exist!", entity.GetIndex(), entity.GetGeneration());
+			throw std::runtime_error("Entity does not exist!");
+		}
+		return m_Slots[entity.GetIndex()];
+	}
+
+	Archetype* Registry::FindArchetype(const ComponentMask& mask) const
+	{
+		auto it = m_ArchetypeLookup.find(mask);
+		return it != m_ArchetypeLookup.end() ? it->second : nullptr;
+	}
+
+	Archetype* Registry::GetOrCreateArchetype(const ComponentMask& mask)
+	{
+		if (Archetype* archetype = FindArchetype(mask))
+		{
+			return archetype;
+		}
+
+		auto archetype = Archetype::Create(mask);
+		Archetype* result = archetype.get();
+
+		m_ArchetypeLookup.emplace(mask, result);
+		m_Archetypes.push_back(std::move(archetype));
+
+		return result;
+	}
+
+	Archetype* Registry::CreateArchetype(const Archetype& source, const ComponentMask& mask, std::unique_ptr<IComponentColumn> extraColumn, ComponentTypeId extraType)
+	{
+		auto archetype = Archetype::CreateFrom(source, mask, std::move(extraColumn), extraType);
+		Archetype* result = archetype.get();
+
+		m_ArchetypeLookup.emplace(mask, result);
+		m_Archetypes.push_back(std::move(archetype));
+
+		return result;
+	}
+
+	void Registry::MoveEntity(EntitySlot& slot, Archetype& destination)
+	{
+		Archetype& source = *slot.archetype;
+		const size_t sourceRow = slot.row;
+
+		const size_t destinationRow = destination.MoveRowFrom(source, sourceRow);
+
+		Entity moved = source.SwapRemove(sourceRow);
+		if (moved.IsValid())
+		{
+			m_Slots[moved.GetIndex()].row = sourceRow;
+		}
+
+		slot.archetype = &destination;
+		slot.row = destinationRow;
+	}
+
+	const std::vector<Archetype*>& Registry::GetMatchingArchetypes(const ComponentMask& mask)
+	{
+		std::lock_guard<std::mutex> lock(m_QueryMutex);
+
+		std::unique_ptr<QueryCache>& cache = m_QueryCaches[mask];
+		if (!cache)
+		{
+			cache = std::make_unique<QueryCache>();
+		}
+
+		for (; cache->scannedArchetypes < m_Archetypes.size(); cache->scannedArchetypes++)
+		{
+			Archetype* archetype = m_Archetypes[cache->scannedArchetypes].get();
+			if (archetype->Matches(mask))
+			{
+				cache->archetypes.push_back(archetype);
+			}
+		}
+
+		return cache->archetypes;
+	}
+}
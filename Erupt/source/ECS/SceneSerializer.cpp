@@ -0,0 +1,520 @@
+#include "ECS/SceneSerializer.h"
+
+#include "core/FileIO.h"
+#include "core/Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace Erupt
+{
+	namespace
+	{
+		constexpr uint32_t SCENE_MAGIC = 0x4E435345;	// "ESCN"
+		constexpr uint32_t SCENE_VERSION = 2;
+		constexpr uint32_t SCENE_VERSION_NO_FORMATS = 1;	// model table without vertex formats
+		constexpr uint32_t SCENE_NONE = ~0u;			// missing model or parent
+		constexpr size_t SCENE_ALIGNMENT = 16;
+
+		// Components known to the scene format, the bit order is the order of the arrays inside a chunk
+		enum SceneComponent : uint32_t
+		{
+			SCENE_TRANSFORM		= 1 << 0,
+			SCENE_COLOR			= 1 << 1,
+			SCENE_MODEL			= 1 << 2,
+			SCENE_POINT_LIGHT	= 1 << 3,
+			SCENE_SPIN			= 1 << 4,
+			SCENE_HIERARCHY		= 1 << 5,
+			SCENE_COMPONENT_COUNT = 6
+		};
+
+		struct SceneHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t entityCount;
+			uint32_t chunkCount;
+			uint32_t modelCount;
+			uint32_t reserved;
+			uint64_t modelTableOffset;
+		};
+
+		struct SceneChunk
+		{
+			uint32_t components;	// SceneComponent bits
+			uint32_t entityCount;
+			uint32_t firstEntity;	// scene index of the first entity in the chunk
+			uint32_t reserved;
+			uint64_t dataOffset;
+		};
+
+		// The matrices of a TransformComponent are derived data, only TRS is stored
+		struct SceneTransform
+		{
+			glm::vec3 translation;
+			glm::vec3 rotation;
+			glm::vec3 scale;
+		};
+
+		// These are copied between file and component storage with a single memcpy per chunk
+		static_assert(std::is_trivially_copyable_v<ColorComponent>, "ColorComponent is copied in bulk");
+		static_assert(std::is_trivially_copyable_v<PointLightComponent>, "PointLightComponent is copied in bulk");
+		static_assert(std::is_trivially_copyable_v<SpinComponent>, "SpinComponent is copied in bulk");
+
+		size_t RecordSize(uint32_t component)
+		{
+			switch (component)
+			{
+				case SCENE_TRANSFORM:	return sizeof(SceneTransform);
+				case SCENE_COLOR:		return sizeof(ColorComponent);
+				case SCENE_MODEL:		return sizeof(uint32_t);
+				case SCENE_POINT_LIGHT:	return sizeof(PointLightComponent);
+				case SCENE_SPIN:		return sizeof(SpinComponent);
+				case SCENE_HIERARCHY:	return sizeof(uint32_t);
+			}
+			return 0;
+		}
+
+		ComponentTypeId RuntimeId(uint32_t component)
+		{
+			switch (component)
+			{
+				case SCENE_TRANSFORM:	return ComponentType::Id<TransformComponent>();
+				case SCENE_COLOR:		return ComponentType::Id<ColorComponent>();
+				case SCENE_MODEL:		return ComponentType::Id<ModelComponent>();
+				case SCENE_POINT_LIGHT:	return ComponentType::Id<PointLightComponent>();
+				case SCENE_SPIN:		return ComponentType::Id<SpinComponent>();
+				case SCENE_HIERARCHY:	return ComponentType::Id<HierarchyComponent>();
+			}
+			return 0;
+		}
+
+		size_t Align(size_t offset)
+		{
+			return (offset + SCENE_ALIGNMENT - 1) & ~(SCENE_ALIGNMENT - 1);
+		}
+
+		template<typename T>
+		void Write(std::vector<char>& buffer, size_t offset, const T& value)
+		{
+			std::memcpy(buffer.data() + offset, &value, sizeof(T));
+		}
+
+		void Append(std::vector<char>& buffer, const void* data, size_t size)
+		{
+			const char* bytes = static_cast<const char*>(data);
+			buffer.insert(buffer.end(), bytes, bytes + size);
+		}
+
+		[[noreturn]] void ThrowCorrupt(const std::string& filePath)
+		{
+			ERUPT_CORE_ERROR("Scene {0} is truncated or corrupt!", filePath);
+			throw std::runtime_error("Corrupt scene file: " + filePath);
+		}
+
+		void CheckRange(const MappedFile& file, uint64_t offset, uint64_t size, const std::string& filePath)
+		{
+			if (offset > file.Size() || size > file.Size() - offset)
+			{
+				ThrowCorrupt(filePath);
+			}
+		}
+
+		// Checked before any entity is created, so a corrupt file cannot leave entities behind: every entity is covered by
+		// exactly one chunk, every component array lies in the file and the parents form a forest that TransformSystem can order
+		void ValidateChunks(const MappedFile& file, const SceneHeader& header, const SceneChunk* chunks, const std::string& filePath)
+		{
+			const uint32_t entityCount = header.entityCount;
+			std::vector<bool> covered(entityCount, false);
+			std::vector<uint32_t> parents(entityCount, SCENE_NONE);
+
+			for (uint32_t chunkIndex = 0; chunkIndex < header.chunkCount; chunkIndex++)
+			{
+				const SceneChunk& chunk = chunks[chunkIndex];
+				if (uint64_t(chunk.firstEntity) + chunk.entityCount > entityCount)
+				{
+					ThrowCorrupt(filePath);
+				}
+
+				for (uint32_t entity = chunk.firstEntity; entity < chunk.firstEntity + chunk.entityCount; entity++)
+				{
+					if (covered[entity])
+					{
+						ThrowCorrupt(filePath);
+					}
+					covered[entity] = true;
+				}
+
+				uint64_t arrayOffset = chunk.dataOffset;
+				for (uint32_t bit = 0; bit < SCENE_COMPONENT_COUNT; bit++)
+				{
+					const uint32_t component = 1u << bit;
+					if (!(chunk.components & component)) continue;
+
+					arrayOffset = Align(arrayOffset);
+					const uint64_t arraySize = uint64_t(chunk.entityCount) * RecordSize(component);
+					CheckRange(file, arrayOffset, arraySize, filePath);
+
+					if (component == SCENE_HIERARCHY)
+					{
+						std::memcpy(parents.data() + chunk.firstEntity, file.Data() + arrayOffset, arraySize);
+					}
+					arrayOffset += arraySize;
+				}
+			}
+
+			if (std::find(covered.begin(), covered.end(), false) != covered.end())
+			{
+				ThrowCorrupt(filePath);
+			}
+
+			// Walks up from every entity, meeting an entity of the same walk again means it is its own ancestor.
+			// Walks stop at entities already known to reach a root, so every entity is visited once
+			enum : uint8_t { UNVISITED, VISITING, DONE };
+			std::vector<uint8_t> state(entityCount, UNVISITED);
+
+			for (uint32_t entity = 0; entity < entityCount; entity++)
+			{
+				uint32_t current = entity;
+				while (current != SCENE_NONE && state[current] == UNVISITED)
+				{
+					if (parents[current] != SCENE_NONE && parents[current] >= entityCount)
+					{
+						ThrowCorrupt(filePath);
+					}
+
+					state[current] = VISITING;
+					current = parents[current];
+				}
+
+				if (current != SCENE_NONE && state[current] == VISITING)
+				{
+					ThrowCorrupt(filePath);
+				}
+
+				for (current = entity; current != SCENE_NONE && state[current] == VISITING; current = parents[current])
+				{
+					state[current] = DONE;
+				}
+			}
+		}
+	}
+
+	void SceneSerializer::Save(Registry& registry, const std::string& filePath)
+	{
+		struct ChunkSource
+		{
+			Archetype* archetype;
+			uint32_t components;
+		};
+
+		std::vector<ChunkSource> sources;
+		std::unordered_map<Entity::index_t, uint32_t> sceneIndices;
+		uint32_t entityCount = 0;
+
+		// Scene indices follow the order in which the chunks are written
+		for (const auto& archetype : registry.GetArchetypes())
+		{
+			if (archetype->Size() == 0) continue;
+
+			uint32_t components = 0;
+			for (uint32_t bit = 0; bit < SCENE_COMPONENT_COUNT; bit++)
+			{
+				if (archetype->GetMask().test(RuntimeId(1u << bit)))
+				{
+					components |= 1u << bit;
+				}
+			}
+
+			if (components == 0) continue;
+
+			for (const Entity& entity : archetype->GetEntities())
+			{
+				sceneIndices.emplace(entity.GetIndex(), entityCount++);
+			}
+			sources.push_back({ archetype.get(), components });
+		}
+
+		std::vector<char> buffer(sizeof(SceneHeader) + sources.size() * sizeof(SceneChunk));
+
+		// Model table
+		std::unordered_map<const Model*, uint32_t> modelIndices;
+		std::vector<const Model*> models;
+		for (const ChunkSource& source : sources)
+		{
+			if (!(source.components & SCENE_MODEL)) continue;
+
+			for (const ModelComponent& model : source.archetype->GetColumn<ModelComponent>())
+			{
+				if (model.model == nullptr || model.model->GetFilePath().empty()) continue;
+
+				if (modelIndices.emplace(model.model.get(), static_cast<uint32_t>(models.size())).second)
+				{
+					models.push_back(model.model.get());
+				}
+			}
+		}
+
+		const size_t modelTableOffset = buffer.size();
+		for (const Model* model : models)
+		{
+			const std::string& path = model->GetFilePath();
+			const uint32_t length = static_cast<uint32_t>(path.size());
+			Append(buffer, &length, sizeof(length));
+			Append(buffer, path.data(), length);
+
+			const uint32_t format = static_cast<uint32_t>(model->GetVertexFormat());
+			Append(buffer, &format, sizeof(format));
+		}
+
+		// Component arrays
+		uint32_t firstEntity = 0;
+		for (size_t chunkIndex = 0; chunkIndex < sources.size(); chunkIndex++)
+		{
+			const ChunkSource& source = sources[chunkIndex];
+			Archetype& archetype = *source.archetype;
+			const uint32_t count = static_cast<uint32_t>(archetype.Size());
+
+			buffer.resize(Align(buffer.size()));
+			const SceneChunk chunk{ source.components, count, firstEntity, 0, buffer.size() };
+			Write(buffer, sizeof(SceneHeader) + chunkIndex * sizeof(SceneChunk), chunk);
+
+			for (uint32_t bit = 0; bit < SCENE_COMPONENT_COUNT; bit++)
+			{
+				const uint32_t component = 1u << bit;
+				if (!(source.components & component)) continue;
+
+				buffer.resize(Align(buffer.size()));
+
+				switch (component)
+				{
+					case SCENE_TRANSFORM:
+					{
+						for (const TransformComponent& transform : archetype.GetColumn<TransformComponent>())
+						{
+							const SceneTransform record{ transform.GetTranslation(), transform.GetRotation(), transform.GetScale() };
+							Append(buffer, &record, sizeof(record));
+						}
+						break;
+					}
+					case SCENE_COLOR:
+						Append(buffer, archetype.GetColumn<ColorComponent>().data(), count * sizeof(ColorComponent));
+						break;
+					case SCENE_MODEL:
+					{
+						for (const ModelComponent& model : archetype.GetColumn<ModelComponent>())
+						{
+							auto it = modelIndices.find(model.model.get());
+							const uint32_t index = it != modelIndices.end() ? it->second : SCENE_NONE;
+							Append(buffer, &index, sizeof(index));
+						}
+						break;
+					}
+					case SCENE_POINT_LIGHT:
+						Append(buffer, archetype.GetColumn<PointLightComponent>().data(), count * sizeof(PointLightComponent));
+						break;
+					case SCENE_SPIN:
+						Append(buffer, archetype.GetColumn<SpinComponent>().data(), count * sizeof(SpinComponent));
+						break;
+					case SCENE_HIERARCHY:
+					{
+						for (const HierarchyComponent& hierarchy : archetype.GetColumn<HierarchyComponent>())
+						{
+							uint32_t parent = SCENE_NONE;
+							if (registry.IsValid(hierarchy.parent))
+							{
+								auto it = sceneIndices.find(hierarchy.parent.GetIndex());
+								parent = it != sceneIndices.end() ? it->second : SCENE_NONE;
+							}
+							Append(buffer, &parent, sizeof(parent));
+						}
+						break;
+					}
+				}
+			}
+
+			firstEntity += count;
+		}
+
+		const SceneHeader header{ SCENE_MAGIC, SCENE_VERSION, entityCount, static_cast<uint32_t>(sources.size()), static_cast<uint32_t>(models.size()), 0, modelTableOffset };
+		Write(buffer, 0, header);
+
+		FileIO::WriteBinaryFile(buffer, filePath);
+		ERUPT_CORE_INFO("Saved scene {0}: {1} entities, {2} chunks, {3} models", filePath, entityCount, sources.size(), models.size());
+	}
+
+	std::vector<Entity> SceneSerializer::Load(Registry& registry, AssetManager& assets, const std::string& filePath)
+	{
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		MappedFile file(filePath);
+		const uint8_t* data = file.Data();
+
+		CheckRange(file, 0, sizeof(SceneHeader), filePath);
+		SceneHeader header;
+		std::memcpy(&header, data, sizeof(header));
+
+		if (header.magic != SCENE_MAGIC || (header.version != SCENE_VERSION && header.version != SCENE_VERSION_NO_FORMATS))
+		{
+			ERUPT_CORE_ERROR("{0} is not a scene file of version {1}!", filePath, SCENE_VERSION);
+			throw std::runtime_error("Unsupported scene file: " + filePath);
+		}
+
+		CheckRange(file, sizeof(SceneHeader), uint64_t(header.chunkCount) * sizeof(SceneChunk), filePath);
+		const SceneChunk* chunks = reinterpret_cast<const SceneChunk*>(data + sizeof(SceneHeader));
+		ValidateChunks(file, header, chunks, filePath);
+
+		// Models are requested from the AssetManager before any entity is created, they stream in while the scene is already in use
+		std::vector<std::string> modelPaths(header.modelCount);
+		std::vector<Model::VertexFormat> modelFormats(header.modelCount, Model::VertexFormat::Full);
+		uint64_t offset = header.modelTableOffset;
+		for (uint32_t modelIndex = 0; modelIndex < header.modelCount; modelIndex++)
+		{
+			std::string& path = modelPaths[modelIndex];
+
+			uint32_t length;
+			CheckRange(file, offset, sizeof(length), filePath);
+			std::memcpy(&length, data + offset, sizeof(length));
+			offset += sizeof(length);
+
+			CheckRange(file, offset, length, filePath);
+			path.assign(reinterpret_cast<const char*>(data + offset), length);
+			offset += length;
+
+			if (header.version == SCENE_VERSION_NO_FORMATS) continue;
+
+			uint32_t format;
+			CheckRange(file, offset, sizeof(format), filePath);
+			std::memcpy(&format, data + offset, sizeof(format));
+			offset += sizeof(format);
+
+			if (format >= static_cast<uint32_t>(Model::VertexFormat::Count))
+			{
+				ERUPT_CORE_ERROR("Scene {0} is truncated or corrupt!", filePath);
+				throw std::runtime_error("Corrupt scene file: " + filePath);
+			}
+			modelFormats[modelIndex] = static_cast<Model::VertexFormat>(format);
+		}
+
+		std::vector<std::shared_ptr<Model>> models;
+		for (uint32_t modelIndex = 0; modelIndex < header.modelCount; modelIndex++)
+		{
+			models.push_back(assets.LoadModel(modelPaths[modelIndex], modelFormats[modelIndex]));
+		}
+
+		struct PendingHierarchy
+		{
+			Archetype* archetype;
+			size_t firstRow;
+			const uint32_t* parents;
+			uint32_t count;
+		};
+
+		std::vector<Entity> entities(header.entityCount);
+		std::vector<PendingHierarchy> hierarchies;
+		std::vector<Entity> withoutModel;		// saved with a missing model, see SCENE_NONE
+
+		for (uint32_t chunkIndex = 0; chunkIndex < header.chunkCount; chunkIndex++)
+		{
+			const SceneChunk& chunk = chunks[chunkIndex];
+			const uint32_t count = chunk.entityCount;
+
+			ComponentMask mask{};
+			for (uint32_t bit = 0; bit < SCENE_COMPONENT_COUNT; bit++)
+			{
+				if (chunk.components & (1u << bit))
+				{
+					mask.set(RuntimeId(1u << bit));
+				}
+			}
+
+			size_t firstRow = 0;
+			Archetype& archetype = registry.CreateEntities(mask, count, entities.data() + chunk.firstEntity, firstRow);
+
+			// Array ranges were checked by ValidateChunks
+			uint64_t arrayOffset = chunk.dataOffset;
+			for (uint32_t bit = 0; bit < SCENE_COMPONENT_COUNT; bit++)
+			{
+				const uint32_t component = 1u << bit;
+				if (!(chunk.components & component)) continue;
+
+				arrayOffset = Align(arrayOffset);
+				const uint64_t arraySize = uint64_t(count) * RecordSize(component);
+				const uint8_t* array = data + arrayOffset;
+
+				switch (component)
+				{
+					case SCENE_TRANSFORM:
+					{
+						const SceneTransform* records = reinterpret_cast<const SceneTransform*>(array);
+						TransformComponent* transforms = archetype.GetColumn<TransformComponent>().data() + firstRow;
+						for (uint32_t i = 0; i < count; i++)
+						{
+							transforms[i].SetTranslation(records[i].translation);
+							transforms[i].SetRotation(records[i].rotation);
+							transforms[i].SetScale(records[i].scale);
+						}
+						break;
+					}
+					case SCENE_COLOR:
+						std::memcpy(archetype.GetColumn<ColorComponent>().data() + firstRow, array, arraySize);
+						break;
+					case SCENE_MODEL:
+					{
+						const uint32_t* indices = reinterpret_cast<const uint32_t*>(array);
+						ModelComponent* modelComponents = archetype.GetColumn<ModelComponent>().data() + firstRow;
+						for (uint32_t i = 0; i < count; i++)
+						{
+							if (indices[i] < models.size())
+							{
+								modelComponents[i].model = models[indices[i]];
+							}
+							else
+							{
+								withoutModel.push_back(entities[chunk.firstEntity + i]);
+							}
+						}
+						break;
+					}
+					case SCENE_POINT_LIGHT:
+						std::memcpy(archetype.GetColumn<PointLightComponent>().data() + firstRow, array, arraySize);
+						break;
+					case SCENE_SPIN:
+						std::memcpy(archetype.GetColumn<SpinComponent>().data() + firstRow, array, arraySize);
+						break;
+					case SCENE_HIERARCHY:
+						// Parents may live in later chunks, resolved once every entity exists
+						hierarchies.push_back({ &archetype, firstRow, reinterpret_cast<const uint32_t*>(array), count });
+						break;
+				}
+
+				arrayOffset += arraySize;
+			}
+		}
+
+		for (const PendingHierarchy& pending : hierarchies)
+		{
+			HierarchyComponent* components = pending.archetype->GetColumn<HierarchyComponent>().data() + pending.firstRow;
+			for (uint32_t i = 0; i < pending.count; i++)
+			{
+				const uint32_t parent = pending.parents[i];
+				components[i].parent = parent != SCENE_NONE ? entities[parent] : Entity{};
+			}
+		}
+
+		// Removing moves rows between archetypes, so it waits until the hierarchies above were resolved
+		for (Entity entity : withoutModel)
+		{
+			registry.RemoveComponent<ModelComponent>(entity);
+		}
+
+		const float milliseconds = std::chrono::duration<float, std::chrono::milliseconds::period>(std::chrono::high_resolution_clock::now() - startTime).count();
+		ERUPT_CORE_INFO("Loaded scene {0}: {1} entities in {2} ms", filePath, entities.size(), milliseconds);
+
+		return entities;
+	}
+}
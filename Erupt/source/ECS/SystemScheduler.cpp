@@ -0,0 +1,118 @@
+#include "ECS/SystemScheduler.h"
+
+#include "core/JobSystem.h"
+#include "core/Log.h"
+
+#include <atomic>
+#include <memory>
+
+namespace Erupt
+{
+	bool SystemAccess::ConflictsWith(const SystemAccess& other) const
+	{
+		if (exclusive || other.exclusive)
+		{
+			return true;
+		}
+
+		const ComponentMask touched = reads | writes;
+		const ComponentMask otherTouched = other.reads | other.writes;
+
+		return (writes & otherTouched).any() || (other.writes & touched).any();
+	}
+
+	void SystemScheduler::AddSystem(const std::string& name, const SystemAccess& access, SystemFunc func)
+	{
+		SystemNode node{};
+		node.name = name;
+		node.access = access;
+		node.func = std::move(func);
+
+		m_Systems.push_back(std::move(node));
+		m_GraphDirty = true;
+	}
+
+	void SystemScheduler::RemoveSystem(const std::string& name)
+	{
+		for (auto it = m_Systems.begin(); it != m_Systems.end(); ++it)
+		{
+			if (it->name == name)
+			{
+				m_Systems.erase(it);
+				m_GraphDirty = true;
+				return;
+			}
+		}
+
+		ERUPT_CORE_WARN("System {0} is not registered!", name);
+	}
+
+	void SystemScheduler::BuildGraph()
+	{
+		for (auto& system : m_Systems)
+		{
+			system.dependents.clear();
+			system.dependencyCount = 0;
+		}
+
+		// A system waits for every earlier system it conflicts with
+		for (size_t i = 0; i < m_Systems.size(); i++)
+		{
+			for (size_t j = i + 1; j < m_Systems.size(); j++)
+			{
+				if (m_Systems[i].access.ConflictsWith(m_Systems[j].access))
+				{
+					m_Systems[i].dependents.push_back(j);
+					m_Systems[j].dependencyCount++;
+				}
+			}
+		}
+
+		m_GraphDirty = false;
+	}
+
+	void SystemScheduler::Run(Registry& registry)
+	{
+		if (m_GraphDirty)
+		{
+			BuildGraph();
+		}
+
+		const size_t systemCount = m_Systems.size();
+
+		std::unique_ptr<std::atomic<size_t>[]> remainingDependencies = std::make_unique<std::atomic<size_t>[]>(systemCount);
+		for (size_t i = 0; i < systemCount; i++)
+		{
+			remainingDependencies[i] = m_Systems[i].dependencyCount;
+		}
+
+		// Every system queues the dependents it was the last dependency of, the counter covers all of them
+		// because a dependent is queued before the system that released it finished
+		JobCounter counter;
+		std::function<void(size_t)> launch = [&](size_t index)
+		{
+			JobSystem::Run([&, index]()
+			{
+				m_Systems[index].func(registry);
+
+				for (size_t dependent : m_Systems[index].dependents)
+				{
+					if (remainingDependencies[dependent].fetch_sub(1) == 1)
+					{
+						launch(dependent);
+					}
+				}
+			}, &counter);
+		};
+
+		for (size_t i = 0; i < systemCount; i++)
+		{
+			if (m_Systems[i].dependencyCount == 0)
+			{
+				launch(i);
+			}
+		}
+
+		JobSystem::Wait(counter);
+	}
+}
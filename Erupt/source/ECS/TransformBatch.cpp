@@ -0,0 +1,131 @@
+#include "ECS/TransformBatch.h"
+#include "ECS/TransformBatchKernel.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace Erupt
+{
+	void TransformBatch::ComputeScalar(
+		const glm::vec3* translations,
+		const glm::vec3* rotations,
+		const glm::vec3* scales,
+		size_t count,
+		glm::mat4* modelMatrices,
+		glm::mat3* normalMatrices)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const glm::vec3& rotation = rotations[i];
+			const glm::vec3& scale = scales[i];
+
+			const float c3 = glm::cos(rotation.z);
+			const float s3 = glm::sin(rotation.z);
+			const float c2 = glm::cos(rotation.x);
+			const float s2 = glm::sin(rotation.x);
+			const float c1 = glm::cos(rotation.y);
+			const float s1 = glm::sin(rotation.y);
+
+			// Columns of the rotation matrix, shared by the model and the normal matrix
+			const glm::vec3 u{ (c1 * c3 + s1 * s2 * s3), (c2 * s3), (c1 * s2 * s3 - c3 * s1) };
+			const glm::vec3 v{ (c3 * s1 * s2 - c1 * s3), (c2 * c3), (c1 * c3 * s2 + s1 * s3) };
+			const glm::vec3 w{ (c2 * s1), (-s2), (c1 * c2) };
+
+			modelMatrices[i] = glm::mat4
+			{
+				glm::vec4(scale.x * u, 0.0f),
+				glm::vec4(scale.y * v, 0.0f),
+				glm::vec4(scale.z * w, 0.0f),
+				glm::vec4(translations[i], 1.0f)
+			};
+
+			const glm::vec3 inverseScale = 1.0f / scale;
+
+			normalMatrices[i] = glm::mat3
+			{
+				inverseScale.x * u,
+				inverseScale.y * v,
+				inverseScale.z * w
+			};
+		}
+	}
+
+	void TransformBatch::Compute(
+		const glm::vec3* translations,
+		const glm::vec3* rotations,
+		const glm::vec3* scales,
+		size_t count,
+		glm::mat4* modelMatrices,
+		glm::mat3* normalMatrices)
+	{
+		size_t done = 0;
+
+		if (UseAvx2())
+		{
+			done = ComputeAvx2(translations, rotations, scales, count, modelMatrices, normalMatrices);
+		}
+#if defined(ERUPT_TRANSFORM_SSE2)
+		// The SSE2 path also takes the 4 to 7 transforms AVX2 left
+		done += ComputeWide<Sse>(
+			reinterpret_cast<const float*>(translations + done),
+			reinterpret_cast<const float*>(rotations + done),
+			reinterpret_cast<const float*>(scales + done),
+			count - done,
+			reinterpret_cast<float*>(modelMatrices + done),
+			reinterpret_cast<float*>(normalMatrices + done));
+#endif
+
+		// Whatever does not fill a whole register goes through the scalar path
+		ComputeScalar(translations + done, rotations + done, scales + done, count - done, modelMatrices + done, normalMatrices + done);
+	}
+
+	const char* TransformBatch::GetInstructionSet()
+	{
+		if (UseAvx2())
+		{
+			return "AVX2";
+		}
+#if defined(ERUPT_TRANSFORM_SSE2)
+		return "SSE2";
+#else
+		return "Scalar";
+#endif
+	}
+
+	bool TransformBatch::UseAvx2()
+	{
+		static const bool useAvx2 = []()
+		{
+			if (!HasAvx2Kernel())
+			{
+				return false;
+			}
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7)
+			{
+				return false;
+			}
+
+			// AVX needs the CPU to support it and the OS to save the YMM registers (OSXSAVE, then XCR0 bits 1 and 2)
+			__cpuid(info, 1);
+			const bool osxsave = (info[2] & (1 << 27)) != 0;
+			const bool avx = (info[2] & (1 << 28)) != 0;
+			if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			{
+				return false;
+			}
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+			return __builtin_cpu_supports("avx2") != 0;
+#else
+			return false;
+#endif
+		}();
+		return useAvx2;
+	}
+}
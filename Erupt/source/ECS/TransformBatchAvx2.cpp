@@ -0,0 +1,42 @@
+#include "ECS/TransformBatch.h"
+#include "ECS/TransformBatchKernel.h"
+
+// Built with /arch:AVX2 (see Erupt.vcxproj), TransformBatch::Compute only calls into it after checking the CPU
+
+namespace Erupt
+{
+	size_t TransformBatch::ComputeAvx2(
+		const glm::vec3* translations,
+		const glm::vec3* rotations,
+		const glm::vec3* scales,
+		size_t count,
+		glm::mat4* modelMatrices,
+		glm::mat3* normalMatrices)
+	{
+#if defined(ERUPT_TRANSFORM_AVX2)
+		// No glm function may be called here, it would be compiled with AVX2 and could replace the copy other files use
+		const size_t done = ComputeWide<Avx2>(
+			reinterpret_cast<const float*>(translations),
+			reinterpret_cast<const float*>(rotations),
+			reinterpret_cast<const float*>(scales),
+			count,
+			reinterpret_cast<float*>(modelMatrices),
+			reinterpret_cast<float*>(normalMatrices));
+
+		// The SSE2 and scalar code running next would pay for the dirty upper halves of the YMM registers on every instruction
+		_mm256_zeroupper();
+		return done;
+#else
+		return 0;
+#endif
+	}
+
+	bool TransformBatch::HasAvx2Kernel()
+	{
+#if defined(ERUPT_TRANSFORM_AVX2)
+		return true;
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,17 @@
+#include "ECS/systems/SpinSystem.h"
+
+namespace Erupt
+{
+	void SpinSystem::Update(Registry& registry, float deltaTime)
+	{
+		for (auto [entity, transform, spin] : registry.View<TransformComponent, SpinComponent>())
+		{
+			transform.Rotate(spin.angularVelocity * deltaTime);
+		}
+	}
+
+	SystemAccess SpinSystem::GetAccess()
+	{
+		return SystemAccess{}.Read<SpinComponent>().Write<TransformComponent>();
+	}
+}
@@ -0,0 +1,300 @@
+#include "ECS/systems/TransformSystem.h"
+#include "ECS/TransformBatch.h"
+
+#include "core/JobSystem.h"
+#include "core/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Erupt
+{
+	void TransformSystem::Update(Registry& registry)
+	{
+		// Entities that moved during the previous tick now start interpolating from where that tick left them
+		for (Entity entity : m_ChangedEntities)
+		{
+			if (!registry.IsValid(entity)) continue;
+
+			if (TransformComponent* transform = registry.TryGetComponent<TransformComponent>(entity))
+			{
+				transform->m_PreviousWorldMatrix = transform->m_WorldMatrix;
+				transform->m_PreviousWorldNormalMatrix = transform->m_WorldNormalMatrix;
+				transform->m_Interpolate = false;
+			}
+		}
+
+		m_ChangedEntities.clear();
+
+		UpdateLocalMatrices(registry);
+
+		bool force = false;
+		if (!m_LevelsBuilt || CountHierarchyNodes(registry) != m_HierarchyNodeCount)
+		{
+			BuildLevels(registry);
+			force = true;
+		}
+
+		if (!PropagateLevels(registry, force))
+		{
+			// A parent was destroyed or changed, this is rare enough to simply redo the whole hierarchy
+			BuildLevels(registry);
+			PropagateLevels(registry, true);
+		}
+
+		// Children that only moved because one of their ancestors did
+		for (const auto& level : m_Levels)
+		{
+			for (const HierarchyNode& node : level)
+			{
+				const TransformComponent& transform = registry.GetComponent<TransformComponent>(node.entity);
+				if (transform.m_WorldChanged && !transform.m_LocalChanged)
+				{
+					m_ChangedEntities.push_back(node.entity);
+				}
+			}
+		}
+
+		for (Entity entity : m_ChangedEntities)
+		{
+			TransformComponent& transform = registry.GetComponent<TransformComponent>(entity);
+			if (transform.m_HasPreviousWorld)
+			{
+				transform.m_Interpolate = true;
+			}
+			else
+			{
+				// Nothing to interpolate from on the first update
+				transform.m_PreviousWorldMatrix = transform.m_WorldMatrix;
+				transform.m_PreviousWorldNormalMatrix = transform.m_WorldNormalMatrix;
+				transform.m_HasPreviousWorld = true;
+			}
+		}
+	}
+
+	SystemAccess TransformSystem::GetAccess()
+	{
+		return SystemAccess{}.Read<HierarchyComponent>().Write<TransformComponent>();
+	}
+
+	void TransformSystem::UpdateLocalMatrices(Registry& registry)
+	{
+		m_DirtyTransforms.clear();
+		m_Translations.clear();
+		m_Rotations.clear();
+		m_Scales.clear();
+
+		registry.View<TransformComponent>().EachChunk([this](size_t count, const Entity* entities, TransformComponent* transforms)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				TransformComponent& transform = transforms[i];
+				transform.m_LocalChanged = transform.IsDirty();
+				transform.m_WorldChanged = transform.m_LocalChanged;
+
+				if (!transform.m_LocalChanged) continue;
+
+				m_ChangedEntities.push_back(entities[i]);
+				m_DirtyTransforms.push_back(&transform);
+				m_Translations.push_back(transform.m_Translation);
+				m_Rotations.push_back(transform.m_Rotation);
+				m_Scales.push_back(transform.m_Scale);
+			}
+		});
+
+		const size_t dirtyCount = m_DirtyTransforms.size();
+		if (dirtyCount == 0)
+		{
+			return;
+		}
+
+		m_Matrices.resize(dirtyCount);
+		m_NormalMatrices.resize(dirtyCount);
+
+		JobSystem::ParallelFor(dirtyCount, BATCH_GRAIN_SIZE, [this](size_t begin, size_t end)
+		{
+			TransformBatch::Compute(
+				m_Translations.data() + begin,
+				m_Rotations.data() + begin,
+				m_Scales.data() + begin,
+				end - begin,
+				m_Matrices.data() + begin,
+				m_NormalMatrices.data() + begin);
+		});
+
+		for (size_t i = 0; i < dirtyCount; i++)
+		{
+			TransformComponent& transform = *m_DirtyTransforms[i];
+			transform.m_Matrix = m_Matrices[i];
+			transform.m_NormalMatrix = m_NormalMatrices[i];
+			transform.m_Dirty = false;
+
+			// Correct for roots, children are overwritten while propagating
+			transform.m_WorldMatrix = transform.m_Matrix;
+			transform.m_WorldNormalMatrix = transform.m_NormalMatrix;
+		}
+	}
+
+	size_t TransformSystem::CountHierarchyNodes(Registry& registry) const
+	{
+		size_t count = 0;
+		registry.View<HierarchyComponent, TransformComponent>().EachChunk([&count](size_t chunkCount, const Entity*, HierarchyComponent*, TransformComponent*)
+		{
+			count += chunkCount;
+		});
+		return count;
+	}
+
+	void TransformSystem::BuildLevels(Registry& registry)
+	{
+		// Entities that were children before fall back to their local transform in case they lost their parent,
+		// the forced propagation that follows a rebuild recomputes the ones that are still attached
+		for (const auto& level : m_Levels)
+		{
+			for (const HierarchyNode& node : level)
+			{
+				if (!registry.IsValid(node.entity)) continue;
+
+				if (TransformComponent* transform = registry.TryGetComponent<TransformComponent>(node.entity))
+				{
+					transform->m_WorldMatrix = transform->m_Matrix;
+					transform->m_WorldNormalMatrix = transform->m_NormalMatrix;
+					transform->m_PreviousWorldMatrix = transform->m_Matrix;
+					transform->m_PreviousWorldNormalMatrix = transform->m_NormalMatrix;
+					transform->m_WorldChanged = true;
+					transform->m_Interpolate = false;
+				}
+			}
+		}
+
+		m_Levels.clear();
+
+		std::unordered_map<Entity::index_t, HierarchyNode> nodes;
+		registry.View<HierarchyComponent, TransformComponent>().EachChunk([&nodes](size_t count, const Entity* entities, HierarchyComponent* hierarchies, TransformComponent*)
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				nodes.emplace(entities[i].GetIndex(), HierarchyNode{ entities[i], hierarchies[i].parent });
+			}
+		});
+
+		// Depth 0 are roots: entities without a parent or whose parent no longer exists
+		std::unordered_map<Entity::index_t, uint32_t> depths;
+		std::vector<Entity::index_t> chain;
+
+		for (const auto& [index, node] : nodes)
+		{
+			// Walk up until a root or a node of known depth, then assign depths on the way back down
+			chain.clear();
+			Entity::index_t current = index;
+			uint32_t depth = 0;
+
+			while (true)
+			{
+				auto known = depths.find(current);
+				if (known != depths.end())
+				{
+					depth = known->second;
+					break;
+				}
+
+				auto currentNode = nodes.find(current);
+				if (currentNode == nodes.end() ||
+					!registry.IsValid(currentNode->second.parent) ||
+					!registry.HasComponent<TransformComponent>(currentNode->second.parent))
+				{
+					depths.emplace(current, 0);
+					break;
+				}
+
+				if (chain.size() > nodes.size())
+				{
+					ERUPT_CORE_ERROR("Entity {0} is its own ancestor!", index);
+					throw std::runtime_error("Cycle in transform hierarchy!");
+				}
+
+				chain.push_back(current);
+				current = currentNode->second.parent.GetIndex();
+			}
+
+			for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+			{
+				depths.emplace(*it, ++depth);
+			}
+		}
+
+		for (const auto& [index, node] : nodes)
+		{
+			const uint32_t depth = depths[index];
+			if (depth == 0) continue;
+
+			if (m_Levels.size() < depth)
+			{
+				m_Levels.resize(depth);
+			}
+			m_Levels[depth - 1].push_back(node);
+		}
+
+		// Keep siblings next to each other so their shared parent stays in cache
+		for (auto& level : m_Levels)
+		{
+			std::sort(level.begin(), level.end(), [](const HierarchyNode& a, const HierarchyNode& b)
+			{
+				return a.parent.GetIndex() != b.parent.GetIndex() ? a.parent.GetIndex() < b.parent.GetIndex() : a.entity.GetIndex() < b.entity.GetIndex();
+			});
+		}
+
+		m_HierarchyNodeCount = nodes.size();
+		m_LevelsBuilt = true;
+	}
+
+	bool TransformSystem::PropagateLevels(Registry& registry, bool force)
+	{
+		std::atomic<bool> valid = true;
+
+		auto propagate = [&registry, &valid, force](const HierarchyNode& node)
+		{
+			if (!registry.IsValid(node.entity) || !registry.IsValid(node.parent))
+			{
+				valid = false;
+				return;
+			}
+
+			const HierarchyComponent* hierarchy = registry.TryGetComponent<HierarchyComponent>(node.entity);
+			TransformComponent* transform = registry.TryGetComponent<TransformComponent>(node.entity);
+			const TransformComponent* parentTransform = registry.TryGetComponent<TransformComponent>(node.parent);
+
+			if (hierarchy == nullptr || hierarchy->parent != node.parent || transform == nullptr || parentTransform == nullptr)
+			{
+				valid = false;
+				return;
+			}
+
+			if (!force && !transform->m_LocalChanged && !parentTransform->m_WorldChanged)
+			{
+				return;
+			}
+
+			transform->m_WorldMatrix = parentTransform->m_WorldMatrix * transform->m_Matrix;
+			transform->m_WorldNormalMatrix = parentTransform->m_WorldNormalMatrix * transform->m_NormalMatrix;
+			transform->m_WorldChanged = true;
+		};
+
+		for (const auto& level : m_Levels)
+		{
+			JobSystem::ParallelFor(level.size(), PROPAGATION_GRAIN_SIZE, [&level, &propagate](size_t begin, size_t end)
+			{
+				std::for_each(level.begin() + begin, level.begin() + end, propagate);
+			});
+
+			if (!valid)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -3,8 +3,13 @@
 #include "core/FileIO.h"
 #include "core/Camera.h"
 #include "core/Input.h"
+#include "core/JobSystem.h"
+
+#include "ECS/SceneSerializer.h"
+#include "ECS/SystemScheduler.h"
+#include "ECS/systems/SpinSystem.h"
+#include "ECS/systems/TransformSystem.h"
 
-#include "graphics/EruptBuffer.h"
 #include "graphics/systems/SimpleRenderSystem.h"
 #include "graphics/systems/PointLightSystem.h"
 
@@ -13,66 +18,83 @@
 
 namespace Erupt
 {
-	Application::Application()
+	Application::Application(const std::string& scenePath, VkDeviceSize stagingCapacity)
+		: m_EruptDevice(m_EruptWindow, stagingCapacity)
 	{
 		m_GlobalPool = EruptDescriptorPool::Builder(m_EruptDevice)
-			.SetMaxSets(EruptSwapChain::MAX_FRAMES_IN_FLIGHT)
-			.AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, EruptSwapChain::MAX_FRAMES_IN_FLIGHT)
+			.SetMaxSets(1)
+			.AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1)
 			.Build();
 
-		LoadEntities();
+		if (scenePath.empty())
+		{
+			LoadEntities();
+		}
+		else
+		{
+			SceneSerializer::Load(m_Registry, m_AssetManager, scenePath);
+		}
 	}
 
 	Application::~Application()
 	{
+		m_ModelLoader.WaitIdle();
+		JobSystem::Shutdown();
 	}
 
 	void Application::Init()
 	{
 		Log::Init();
 		FileIO::Init();
+		JobSystem::Init();
 		ERUPT_CORE_INFO("Initializing Erupt Engine!");
 	}
 
 	void Application::Run()
 	{
-		// Creating 2 UBOs for each frame in flight so that there is no need for idling between frames
-		std::vector<std::unique_ptr<EruptBuffer>> uboBuffers(EruptSwapChain::MAX_FRAMES_IN_FLIGHT);
-		for (int i = 0; i < uboBuffers.size(); i++)
-		{
-			uboBuffers[i] = std::make_unique<EruptBuffer>(
-				m_EruptDevice,
-				sizeof(GlobalUbo),
-				1,
-				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-			uboBuffers[i]->Map();
-		}
+		// The GlobalUbo of every frame is written to the frame allocator, one set serves all frames in flight through its dynamic offset
+		FrameAllocator& frameAllocator = m_EruptRenderer.GetFrameAllocator();
 
 		auto globalSetLayout = EruptDescriptorSetLayout::Builder(m_EruptDevice)
-			.AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+			.AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL_GRAPHICS)
 			.Build();
 
-		std::vector<VkDescriptorSet> globalDescriptorSets(EruptSwapChain::MAX_FRAMES_IN_FLIGHT);
-		for (int i = 0; i < globalDescriptorSets.size(); i++)
-		{
-			auto bufferInfo = uboBuffers[i]->DescriptorInfo();
-			EruptDescriptorWriter(*globalSetLayout, *m_GlobalPool)
-				.WriteBuffer(0, &bufferInfo)
-				.Build(globalDescriptorSets[i]);
-		}
+		VkDescriptorSet globalDescriptorSet;
+		auto bufferInfo = frameAllocator.DescriptorInfo(sizeof(GlobalUbo));
+		EruptDescriptorWriter(*globalSetLayout, *m_GlobalPool)
+			.WriteBuffer(0, &bufferInfo)
+			.Build(globalDescriptorSet);
 
 		SimpleRenderSystem simpleRenderSystem{ m_EruptDevice, m_EruptRenderer.GetSwapChainRenderPass(), globalSetLayout->GetDescriptorSetLayout() };
 		PointLightSystem pointLightSystem{ m_EruptDevice, m_EruptRenderer.GetSwapChainRenderPass(), globalSetLayout->GetDescriptorSetLayout()};
+		TransformSystem transformSystem{};
+		SpinSystem spinSystem{};
+
+		// Simulation systems, run once per fixed tick and scheduled on worker threads according to the components they touch
+		float tickDelta = 1.f / m_TickRate;
+
+		SystemScheduler scheduler{};
+		scheduler.AddSystem("Spin", SpinSystem::GetAccess(), [&](Registry& registry)
+		{
+			spinSystem.Update(registry, tickDelta);
+		});
+		scheduler.AddSystem("Transform", TransformSystem::GetAccess(), [&](Registry& registry)
+		{
+			transformSystem.Update(registry);
+		});
+
+		// Gives the first frame valid matrices before any tick ran
+		transformSystem.Update(m_Registry);
 
 		Camera camera{};
 		camera.SetViewDirection(glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f));
 
-		auto viewerEntity = Entity::CreateEntity();
-		viewerEntity.m_Transform.translation.z = -2.5;
+		auto viewerEntity = m_Registry.CreateEntity();
+		m_Registry.AddComponent<TransformComponent>(viewerEntity).SetTranslation({ 0.f, 0.f, -2.5f });
 		Input cameraControler{};
 
 		auto currentTime = std::chrono::high_resolution_clock::now();
+		float accumulator = 0.f;
 
 		while (!m_EruptWindow.ShouldClose())
 		{
@@ -82,29 +104,41 @@ namespace Erupt
 			float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
 			currentTime = newTime;
 
-			// Max frame time??? For when polling events takes longer?
-			//deltaTime = glm::min(deltaTime, MAX_FRAME_TIME);
+			deltaTime = glm::min(deltaTime, MAX_FRAME_TIME);
+
+			// Simulation advances in fixed ticks, the remainder carries over into the next frame
+			tickDelta = 1.f / m_TickRate;
+			accumulator += deltaTime;
+			while (accumulator >= tickDelta)
+			{
+				scheduler.Run(m_Registry);
+				accumulator -= tickDelta;
+			}
+			const float interpolationAlpha = accumulator / tickDelta;
 
-			cameraControler.MoveInPlaneXZ(m_EruptWindow.GetWindow(), deltaTime, viewerEntity);
-			camera.SetViewYXZ(viewerEntity.m_Transform.translation, viewerEntity.m_Transform.rotation);
+			auto& viewerTransform = m_Registry.GetComponent<TransformComponent>(viewerEntity);
+			cameraControler.MoveInPlaneXZ(m_EruptWindow.GetWindow(), deltaTime, viewerTransform);
+			camera.SetViewYXZ(viewerTransform.GetTranslation(), viewerTransform.GetRotation());
 			
 			float aspectRatio = m_EruptRenderer.GetAspectRatio();
 			camera.SetPerspectiveProjection(glm::radians(50.f), aspectRatio, 0.1f, 1000.f);
 
+			// Models streamed in by the loader become visible once their upload finished
+			m_ModelLoader.Update();
+			m_AssetManager.Update();
+
 			if (auto commandBuffer = m_EruptRenderer.BeginFrame())
 			{
 				int frameIndex = m_EruptRenderer.GetFrameIndex();
-				FrameInfo frameInfo{frameIndex, deltaTime, commandBuffer, camera, globalDescriptorSets[frameIndex], m_Entities};
+				FrameInfo frameInfo{frameIndex, deltaTime, interpolationAlpha, commandBuffer, camera, globalDescriptorSet, 0, frameAllocator, m_Registry};
 
 				// Update
 				GlobalUbo ubo{};
 				ubo.projection = camera.GetProjection();
 				ubo.view = camera.GetView();
-
 				pointLightSystem.Update(frameInfo, ubo);
 
-				uboBuffers[frameIndex]->WriteToBuffer(&ubo);
-				uboBuffers[frameIndex]->Flush();
+				frameInfo.globalUboOffset = frameAllocator.Push(ubo).GetDynamicOffset();
 
 				// Render
 
@@ -123,34 +157,43 @@ namespace Erupt
 		vkDeviceWaitIdle(m_EruptDevice.Device());
 	}
 
-	void Application::LoadEntities()
+	void Application::SetTickRate(float ticksPerSecond)
 	{
-		std::shared_ptr<Model> flatVase = Model::CreateModelFromFile(m_EruptDevice, "models/flat_vase.obj");
-
-		auto flatVaseEntity = Entity::CreateEntity();
-		flatVaseEntity.m_Model = flatVase;
-		flatVaseEntity.m_Transform.translation = { .5f, .5f, 0.f };
-		flatVaseEntity.m_Transform.scale = { 3.f, 4.f, 3.f };
-
-		m_Entities.emplace(flatVaseEntity.GetId(), std::move(flatVaseEntity));
-
-		std::shared_ptr<Model> vase = Model::CreateModelFromFile(m_EruptDevice, "models/smooth_vase.obj");
-
-		auto smoothVaseEntity = Entity::CreateEntity();
-		smoothVaseEntity.m_Model = vase;
-		smoothVaseEntity.m_Transform.translation = { -.5f, .5f, 0.f };
-		smoothVaseEntity.m_Transform.scale = { 3.f, 4.f, 3.f };
-
-		m_Entities.emplace(smoothVaseEntity.GetId(), std::move(smoothVaseEntity));
-
-		std::shared_ptr<Model> quad = Model::CreateModelFromFile(m_EruptDevice, "models/quad.obj");
+		assert(ticksPerSecond > 0.f && "Tick rate must be positive");
+		m_TickRate = ticksPerSecond;
+	}
 
-		auto floor = Entity::CreateEntity();
-		floor.m_Model = quad;
-		floor.m_Transform.translation = { 0.f, .5f, 0.f };
-		floor.m_Transform.scale = { 3.f, 1.f, 3.f };
+	void Application::SaveScene(const std::string& filePath)
+	{
+		SceneSerializer::Save(m_Registry, filePath);
+	}
 
-		m_Entities.emplace(floor.GetId(), std::move(floor));
+	void Application::LoadEntities()
+	{
+		// Streamed in while the first frames render, entities show up once their model is ready
+		std::shared_ptr<Model> flatVase = m_AssetManager.LoadModel("models/flat_vase.obj", Model::VertexFormat::PackedQuantized);
+		std::shared_ptr<Model> vase = m_AssetManager.LoadModel("models/smooth_vase.obj", Model::VertexFormat::PackedQuantized);
+		std::shared_ptr<Model> quad = m_AssetManager.LoadModel("models/quad.obj", Model::VertexFormat::PackedHalf);
+
+		auto flatVaseEntity = m_Registry.CreateEntity();
+		auto& flatVaseTransform = m_Registry.AddComponent<TransformComponent>(flatVaseEntity);
+		flatVaseTransform.SetTranslation({ .5f, .5f, 0.f });
+		flatVaseTransform.SetScale({ 3.f, 4.f, 3.f });
+		m_Registry.AddComponent<ModelComponent>(flatVaseEntity, flatVase);
+		m_Registry.AddComponent<SpinComponent>(flatVaseEntity, glm::vec3{ 0.f, 1.f, 0.f });
+
+		auto smoothVaseEntity = m_Registry.CreateEntity();
+		auto& smoothVaseTransform = m_Registry.AddComponent<TransformComponent>(smoothVaseEntity);
+		smoothVaseTransform.SetTranslation({ -.5f, .5f, 0.f });
+		smoothVaseTransform.SetScale({ 3.f, 4.f, 3.f });
+		m_Registry.AddComponent<ModelComponent>(smoothVaseEntity, vase);
+		m_Registry.AddComponent<SpinComponent>(smoothVaseEntity, glm::vec3{ 0.f, 1.f, 0.f });
+
+		auto floor = m_Registry.CreateEntity();
+		auto& floorTransform = m_Registry.AddComponent<TransformComponent>(floor);
+		floorTransform.SetTranslation({ 0.f, .5f, 0.f });
+		floorTransform.SetScale({ 3.f, 1.f, 3.f });
+		m_Registry.AddComponent<ModelComponent>(floor, quad);
 
 		std::vector<glm::vec3> lightColors
 		{
@@ -162,15 +205,18 @@ namespace Erupt
 			{1.f, 1.f, 1.f}
 		};
 
+		// The lights are children of the rig, spinning the rig orbits all of them
+		auto lightRig = m_Registry.CreateEntity();
+		m_Registry.AddComponent<TransformComponent>(lightRig);
+		m_Registry.AddComponent<SpinComponent>(lightRig, glm::vec3{ 0.f, -1.f, 0.f });
+
 		for (int i = 0; i < lightColors.size(); i++)
 		{
-			auto pointLight = Entity::MakePointLight(0.2f);
-			pointLight.m_Color = lightColors[i];
+			auto pointLight = Entity::MakePointLight(m_Registry, 0.2f, 0.1f, lightColors[i]);
+			m_Registry.AddComponent<HierarchyComponent>(pointLight, lightRig);
 
 			auto rotateLight = glm::rotate(glm::mat4(1.f), (i * glm::two_pi<float>()) / lightColors.size(), { 0.f, -1.f, 0.f });
-			pointLight.m_Transform.translation = glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f));
-
-			m_Entities.emplace(pointLight.GetId(), std::move(pointLight));
+			m_Registry.GetComponent<TransformComponent>(pointLight).SetTranslation(glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f)));
 		}
 	}
-}
\ No newline at end of file
+}
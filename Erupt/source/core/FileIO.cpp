@@ -8,6 +8,17 @@
 #include <fstream>
 #include <vector>
 
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
 namespace Erupt
 {
 	std::string FileIO::m_ResourcesPath = "";
@@ -78,4 +89,123 @@ namespace Erupt
 
 		return good;
 	}
-}
\ No newline at end of file
+
+	bool FileIO::WriteBinaryFile(const std::vector<char>& data, const std::string& filePath)
+	{
+		const std::string path = GetResourcesPath() + filePath;
+
+		const std::filesystem::path directory = std::filesystem::path(path).parent_path();
+		if (!directory.empty())
+		{
+			std::filesystem::create_directories(directory);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open())
+		{
+			ERUPT_CORE_ERROR("File with path: {0} could not be opened for writing", path.c_str());
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+
+		file.write(data.data(), data.size());
+		file.close();
+
+		return true;
+	}
+
+	MappedFile::MappedFile(const std::string& filePath)
+	{
+		const std::string path = FileIO::GetResourcesPath() + filePath;
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			ERUPT_CORE_ERROR("File with path: {0} could not be found. maybe?", path.c_str());
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+		m_File = file;
+
+		LARGE_INTEGER size{};
+		GetFileSizeEx(file, &size);
+		m_Size = static_cast<size_t>(size.QuadPart);
+
+		if (m_Size == 0)
+		{
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (data == nullptr)
+		{
+			if (mapping != nullptr)
+			{
+				CloseHandle(mapping);
+			}
+			CloseHandle(file);
+
+			ERUPT_CORE_ERROR("File with path: {0} could not be mapped", path.c_str());
+			throw std::runtime_error("Failed to map file: " + path);
+		}
+
+		m_Mapping = mapping;
+		m_Data = static_cast<const uint8_t*>(data);
+#else
+		m_File = open(path.c_str(), O_RDONLY);
+		if (m_File < 0)
+		{
+			ERUPT_CORE_ERROR("File with path: {0} could not be found. maybe?", path.c_str());
+			throw std::runtime_error("Failed to open file: " + path);
+		}
+
+		struct stat status{};
+		fstat(m_File, &status);
+		m_Size = static_cast<size_t>(status.st_size);
+
+		if (m_Size == 0)
+		{
+			return;
+		}
+
+		void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+		if (data == MAP_FAILED)
+		{
+			close(m_File);
+
+			ERUPT_CORE_ERROR("File with path: {0} could not be mapped", path.c_str());
+			throw std::runtime_error("Failed to map file: " + path);
+		}
+
+		m_Data = static_cast<const uint8_t*>(data);
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+#ifdef _WIN32
+		if (m_Data != nullptr)
+		{
+			UnmapViewOfFile(m_Data);
+		}
+		if (m_Mapping != nullptr)
+		{
+			CloseHandle(m_Mapping);
+		}
+		if (m_File != nullptr)
+		{
+			CloseHandle(m_File);
+		}
+#else
+		if (m_Data != nullptr)
+		{
+			munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		}
+		if (m_File >= 0)
+		{
+			close(m_File);
+		}
+#endif
+	}
+}
@@ -4,7 +4,7 @@
 
 namespace Erupt
 {
-	void Erupt::Input::MoveInPlaneXZ(GLFWwindow* window, float dt, Entity& entity)
+	void Erupt::Input::MoveInPlaneXZ(GLFWwindow* window, float dt, TransformComponent& transform)
 	{
 		glm::vec3 rotate{ 0.f };
 		if (glfwGetKey(window, m_Keys.lookRight) == GLFW_PRESS) rotate.y += 1.f;
@@ -14,14 +14,16 @@ namespace Erupt
 
 		if (glm::dot(rotate, rotate) > std::numeric_limits<float>::epsilon())
 		{
-			entity.m_Transform.rotation += m_LookSpeed * dt * glm::normalize(rotate);
+			transform.Rotate(m_LookSpeed * dt * glm::normalize(rotate));
 		}
 
 		// limit pitch values between +/- 85ish degrees
-		entity.m_Transform.rotation.x = glm::clamp(entity.m_Transform.rotation.x, -1.5f, 1.5f);
-		entity.m_Transform.rotation.y = glm::mod(entity.m_Transform.rotation.y, glm::two_pi<float>());
+		glm::vec3 rotation = transform.GetRotation();
+		rotation.x = glm::clamp(rotation.x, -1.5f, 1.5f);
+		rotation.y = glm::mod(rotation.y, glm::two_pi<float>());
+		transform.SetRotation(rotation);
 
-		float yaw = entity.m_Transform.rotation.y;
+		float yaw = rotation.y;
 		const glm::vec3 forwarDir{ sin(yaw), 0.f, cos(yaw) };
 		const glm::vec3 rightDir{ forwarDir.z, 0.f, -forwarDir.x };
 		const glm::vec3 upDir{ 0.f, -1.f, 0.f };
@@ -36,7 +38,7 @@ namespace Erupt
 
 		if (glm::dot(moveDir, moveDir) > std::numeric_limits<float>::epsilon())
 		{
-			entity.m_Transform.translation += m_MoveSpeed * dt * glm::normalize(moveDir);
+			transform.Translate(m_MoveSpeed * dt * glm::normalize(moveDir));
 		}
 	}
 
@@ -0,0 +1,309 @@
+#include "core/JobSystem.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+
+namespace Erupt
+{
+	std::vector<std::unique_ptr<JobSystem::WorkQueue>> JobSystem::s_Queues;
+	std::vector<std::thread> JobSystem::s_Workers;
+	JobSystem::WorkQueue JobSystem::s_BackgroundQueue;
+
+	std::atomic<size_t> JobSystem::s_QueuedJobs = 0;
+	std::atomic<bool> JobSystem::s_Running = false;
+	std::mutex JobSystem::s_WakeMutex;
+	std::condition_variable JobSystem::s_WakeCondition;
+
+	thread_local uint32_t JobSystem::s_QueueIndex = 0;
+
+	void JobSystem::Init(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		}
+
+		s_Running = true;
+		s_QueueIndex = 0;
+
+		for (uint32_t i = 0; i < threadCount + 1; i++)
+		{
+			s_Queues.push_back(std::make_unique<WorkQueue>());
+		}
+
+		for (uint32_t i = 1; i < threadCount + 1; i++)
+		{
+			s_Workers.emplace_back(WorkerLoop, i);
+		}
+
+		ERUPT_CORE_INFO("Job system started with {0} worker threads", threadCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(s_WakeMutex);
+			s_Running = false;
+		}
+		s_WakeCondition.notify_all();
+
+		for (auto& worker : s_Workers)
+		{
+			worker.join();
+		}
+
+		s_Workers.clear();
+		s_Queues.clear();
+		s_BackgroundQueue.jobs.clear();
+		s_QueuedJobs = 0;
+	}
+
+	uint32_t JobSystem::GetThreadCount()
+	{
+		return static_cast<uint32_t>(std::max<size_t>(s_Queues.size(), 1));
+	}
+
+	void JobSystem::Run(Job job, JobCounter* counter, JobCounter* dependency)
+	{
+		if (counter != nullptr)
+		{
+			counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		if (dependency != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+			if (!dependency->IsDone())
+			{
+				dependency->m_Dependents.push_back({ std::move(job), counter });
+				return;
+			}
+		}
+
+		Push({ std::move(job), counter });
+	}
+
+	void JobSystem::RunBackground(Job job, JobCounter* counter)
+	{
+		if (counter != nullptr)
+		{
+			counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		JobCounter::DeferredJob deferred{ std::move(job), counter };
+		if (s_Workers.empty())
+		{
+			Execute(deferred);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_BackgroundQueue.mutex);
+			s_BackgroundQueue.jobs.push_back(std::move(deferred));
+		}
+
+		s_QueuedJobs.fetch_add(1);
+		{
+			std::lock_guard<std::mutex> lock(s_WakeMutex);
+		}
+		s_WakeCondition.notify_one();
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		while (!counter.IsDone())
+		{
+			if (!TryExecuteOne())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		std::exception_ptr exception;
+		{
+			std::lock_guard<std::mutex> lock(counter.m_Mutex);
+			std::swap(exception, counter.m_Exception);
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& func)
+	{
+		grainSize = std::max<size_t>(grainSize, 1);
+
+		// Not worth the overhead, or there is nobody to share the work with
+		if (count <= grainSize || s_Workers.empty())
+		{
+			if (count > 0)
+			{
+				func(0, count);
+			}
+			return;
+		}
+
+		JobCounter counter;
+		for (size_t begin = 0; begin < count; begin += grainSize)
+		{
+			const size_t end = std::min(begin + grainSize, count);
+			Run([&func, begin, end]() { func(begin, end); }, &counter);
+		}
+
+		Wait(counter);
+	}
+
+	void JobSystem::WorkerLoop(uint32_t queueIndex)
+	{
+		s_QueueIndex = queueIndex;
+
+		while (true)
+		{
+			// Background jobs only once there is no other work, see RunBackground
+			if (TryExecuteOne() || TryExecuteBackground())
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(s_WakeMutex);
+			s_WakeCondition.wait(lock, []() { return s_QueuedJobs.load() > 0 || !s_Running; });
+
+			if (!s_Running)
+			{
+				return;
+			}
+		}
+	}
+
+	void JobSystem::Push(JobCounter::DeferredJob job)
+	{
+		// Threads that are not part of the job system (or a system that was never initialized) share the main queue
+		if (s_Queues.empty())
+		{
+			Execute(job);
+			return;
+		}
+
+		const uint32_t queueIndex = s_QueueIndex < s_Queues.size() ? s_QueueIndex : 0;
+		WorkQueue& queue = *s_Queues[queueIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+
+		// Taking the wake mutex orders the increment with a worker that is about to sleep, so the notification is not lost
+		s_QueuedJobs.fetch_add(1);
+		{
+			std::lock_guard<std::mutex> lock(s_WakeMutex);
+		}
+		s_WakeCondition.notify_one();
+	}
+
+	bool JobSystem::TryExecuteOne()
+	{
+		const size_t queueCount = s_Queues.size();
+		if (queueCount == 0)
+		{
+			return false;
+		}
+
+		const uint32_t ownIndex = s_QueueIndex < queueCount ? s_QueueIndex : 0;
+
+		// Newest job of our own queue first, it is the most likely to still be in cache
+		for (size_t i = 0; i < queueCount; i++)
+		{
+			WorkQueue& queue = *s_Queues[(ownIndex + i) % queueCount];
+
+			JobCounter::DeferredJob job;
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (queue.jobs.empty()) continue;
+
+				if (i == 0)
+				{
+					job = std::move(queue.jobs.back());
+					queue.jobs.pop_back();
+				}
+				else
+				{
+					job = std::move(queue.jobs.front());
+					queue.jobs.pop_front();
+				}
+			}
+
+			s_QueuedJobs.fetch_sub(1);
+			Execute(job);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool JobSystem::TryExecuteBackground()
+	{
+		JobCounter::DeferredJob job;
+		{
+			std::lock_guard<std::mutex> lock(s_BackgroundQueue.mutex);
+			if (s_BackgroundQueue.jobs.empty())
+			{
+				return false;
+			}
+
+			job = std::move(s_BackgroundQueue.jobs.front());
+			s_BackgroundQueue.jobs.pop_front();
+		}
+
+		s_QueuedJobs.fetch_sub(1);
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::Execute(JobCounter::DeferredJob& job)
+	{
+		std::exception_ptr exception;
+		try
+		{
+			job.job();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+
+		Finish(job.counter, exception);
+	}
+
+	void JobSystem::Finish(JobCounter* counter, std::exception_ptr exception)
+	{
+		if (counter == nullptr)
+		{
+			if (exception)
+			{
+				ERUPT_CORE_ERROR("Job without a counter threw an exception, it is dropped!");
+			}
+			return;
+		}
+
+		std::vector<JobCounter::DeferredJob> dependents;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_Mutex);
+			if (exception && !counter->m_Exception)
+			{
+				counter->m_Exception = exception;
+			}
+
+			if (counter->m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::swap(dependents, counter->m_Dependents);
+			}
+		}
+
+		for (auto& dependent : dependents)
+		{
+			Push(std::move(dependent));
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#include "core/RangeAllocator.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace Erupt
+{
+	RangeAllocator::RangeAllocator(uint64_t size)
+		: m_Size(size)
+	{
+		if (size > 0)
+		{
+			m_FreeRanges.emplace(0, size);
+		}
+	}
+
+	std::optional<uint64_t> RangeAllocator::Allocate(uint64_t size, uint64_t alignment)
+	{
+		assert(size > 0 && alignment > 0 && "Invalid allocation!");
+
+		for (auto it = m_FreeRanges.begin(); it != m_FreeRanges.end(); ++it)
+		{
+			const uint64_t rangeOffset = it->first;
+			const uint64_t rangeSize = it->second;
+
+			const uint64_t offset = (rangeOffset + alignment - 1) / alignment * alignment;
+			const uint64_t padding = offset - rangeOffset;
+			if (padding + size > rangeSize) continue;
+
+			// The padding in front and the rest behind the allocation stay free
+			m_FreeRanges.erase(it);
+			if (padding > 0)
+			{
+				m_FreeRanges.emplace(rangeOffset, padding);
+			}
+			if (padding + size < rangeSize)
+			{
+				m_FreeRanges.emplace(offset + size, rangeSize - padding - size);
+			}
+
+			m_Allocations.emplace(offset, size);
+			m_Used += size;
+			return offset;
+		}
+
+		return std::nullopt;
+	}
+
+	void RangeAllocator::Free(uint64_t offset)
+	{
+		auto allocation = m_Allocations.find(offset);
+		assert(allocation != m_Allocations.end() && "Offset was not allocated!");
+
+		const uint64_t size = allocation->second;
+		m_Allocations.erase(allocation);
+		m_Used -= size;
+
+		AddFreeRange(offset, size);
+	}
+
+	void RangeAllocator::Grow(uint64_t size)
+	{
+		assert(size >= m_Size && "Ranges cannot shrink!");
+
+		if (size > m_Size)
+		{
+			AddFreeRange(m_Size, size - m_Size);
+			m_Size = size;
+		}
+	}
+
+	uint64_t RangeAllocator::GetUsedExtent() const
+	{
+		if (!m_FreeRanges.empty())
+		{
+			const auto& [offset, size] = *m_FreeRanges.rbegin();
+			if (offset + size == m_Size)
+			{
+				return offset;
+			}
+		}
+		return m_Size;
+	}
+
+	void RangeAllocator::AddFreeRange(uint64_t offset, uint64_t size)
+	{
+		auto next = m_FreeRanges.lower_bound(offset);
+
+		if (next != m_FreeRanges.begin())
+		{
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset)
+			{
+				offset = previous->first;
+				size += previous->second;
+				m_FreeRanges.erase(previous);
+			}
+		}
+
+		if (next != m_FreeRanges.end() && offset + size == next->first)
+		{
+			size += next->second;
+			m_FreeRanges.erase(next);
+		}
+
+		m_FreeRanges.emplace(offset, size);
+	}
+}
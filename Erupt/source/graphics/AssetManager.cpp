@@ -0,0 +1,103 @@
+#include "graphics/AssetManager.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Erupt
+{
+	AssetManager::AssetManager(ModelLoader& loader, size_t budget)
+		: m_Loader(loader), m_Budget(budget)
+	{
+	}
+
+	std::shared_ptr<Model> AssetManager::LoadModel(const std::string& filepath, Model::VertexFormat format)
+	{
+		const std::string key = GetKey(filepath, format);
+
+		auto it = m_Assets.find(key);
+		if (it == m_Assets.end())
+		{
+			it = m_Assets.emplace(key, Asset{ m_Loader.LoadAsync(filepath, format) }).first;
+		}
+
+		it->second.lastUsed = m_Frame;
+		return it->second.model;
+	}
+
+	void AssetManager::Update()
+	{
+		m_Frame++;
+
+		size_t usage = 0;
+		std::vector<std::pair<uint64_t, const std::string*>> unreferenced;
+
+		for (auto& [key, asset] : m_Assets)
+		{
+			usage += GetMemoryUsage(*asset.model);
+
+			// Loading models are also held by the loader
+			if (asset.model.use_count() > 1)
+			{
+				asset.lastUsed = m_Frame;
+			}
+			else
+			{
+				unreferenced.emplace_back(asset.lastUsed, &key);
+			}
+		}
+
+		if (usage <= m_Budget)
+		{
+			return;
+		}
+
+		std::sort(unreferenced.begin(), unreferenced.end());
+
+		const size_t startUsage = usage;
+		size_t evicted = 0;
+		for (const auto& [lastUsed, key] : unreferenced)
+		{
+			if (usage <= m_Budget) break;
+
+			auto it = m_Assets.find(*key);
+			usage -= GetMemoryUsage(*it->second.model);
+			m_Assets.erase(it);
+			evicted++;
+		}
+
+		m_EvictionCount += evicted;
+		if (evicted > 0)
+		{
+			ERUPT_CORE_INFO("Evicted {0} models: {1:.1f} -> {2:.1f} MiB, budget {3:.1f} MiB", evicted,
+				startUsage / 1048576.0, usage / 1048576.0, m_Budget / 1048576.0);
+		}
+	}
+
+	AssetManager::Statistics AssetManager::GetStatistics() const
+	{
+		Statistics statistics{};
+		statistics.assetCount = m_Assets.size();
+		statistics.evictionCount = m_EvictionCount;
+
+		for (const auto& [key, asset] : m_Assets)
+		{
+			statistics.referencedCount += asset.model.use_count() > 1 ? 1 : 0;
+			statistics.cpuBytes += asset.model->GetCpuMemoryUsage();
+			statistics.gpuBytes += asset.model->GetGpuMemoryUsage();
+		}
+		return statistics;
+	}
+
+	std::string AssetManager::GetKey(const std::string& filepath, Model::VertexFormat format)
+	{
+		// The same file spelled with either separator is one asset
+		std::string key = filepath;
+		std::replace(key.begin(), key.end(), '\\', '/');
+
+		key += '#';
+		key += std::to_string(static_cast<uint32_t>(format));
+		return key;
+	}
+}
@@ -0,0 +1,235 @@
+#include "graphics/EruptAllocator.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace Erupt
+{
+	struct MemoryBlock
+	{
+		VkDeviceMemory memory = VK_NULL_HANDLE;
+		VkDeviceSize size = 0;
+		uint32_t memoryType = 0;
+		bool linear = false;
+		bool dedicated = false;
+		void* mapped = nullptr;
+		uint32_t allocationCount = 0;
+		RangeAllocator ranges;
+	};
+
+	EruptAllocator::EruptAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize)
+		: m_Device(device), m_BlockSize(blockSize)
+	{
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+		m_NonCoherentAtomSize = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+	}
+
+	EruptAllocator::~EruptAllocator()
+	{
+		for (auto& block : m_Blocks)
+		{
+			if (block->allocationCount > 0)
+			{
+				ERUPT_CORE_WARN("{0} allocations of memory type {1} were never freed!", block->allocationCount, block->memoryType);
+			}
+			DestroyBlock(*block);
+		}
+	}
+
+	EruptAllocation EruptAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear)
+	{
+		const uint32_t memoryType = FindMemoryType(requirements.memoryTypeBits, properties);
+		const VkMemoryPropertyFlags typeFlags = m_MemoryProperties.memoryTypes[memoryType].propertyFlags;
+
+		// Flushed ranges of non coherent memory have to start on an atom, which neighbours must not share
+		VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+		VkDeviceSize size = requirements.size;
+		if ((typeFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && !(typeFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+		{
+			alignment = std::max(alignment, m_NonCoherentAtomSize);
+			size = (size + m_NonCoherentAtomSize - 1) / m_NonCoherentAtomSize * m_NonCoherentAtomSize;
+		}
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Small heaps (e.g. device local host visible memory) get smaller blocks
+		const uint32_t heapIndex = m_MemoryProperties.memoryTypes[memoryType].heapIndex;
+		const VkDeviceSize blockSize = std::min(m_BlockSize, m_MemoryProperties.memoryHeaps[heapIndex].size / 8);
+
+		MemoryBlock* block = nullptr;
+		std::optional<uint64_t> offset;
+
+		if (size * 2 >= blockSize)
+		{
+			block = &CreateBlock(memoryType, linear, size, true);
+			offset = block->ranges.Allocate(size, alignment);
+		}
+		else
+		{
+			for (auto& candidate : m_Blocks)
+			{
+				if (candidate->dedicated || candidate->memoryType != memoryType || candidate->linear != linear) continue;
+
+				offset = candidate->ranges.Allocate(size, alignment);
+				if (offset)
+				{
+					block = candidate.get();
+					break;
+				}
+			}
+
+			if (!block)
+			{
+				block = &CreateBlock(memoryType, linear, blockSize, false);
+				offset = block->ranges.Allocate(size, alignment);
+			}
+		}
+		assert(offset && "A new block must fit the allocation!");
+
+		block->allocationCount++;
+
+		EruptAllocation allocation{};
+		allocation.memory = block->memory;
+		allocation.offset = *offset;
+		allocation.size = size;
+		allocation.mapped = block->mapped ? static_cast<char*>(block->mapped) + *offset : nullptr;
+		allocation.block = block;
+		return allocation;
+	}
+
+	void EruptAllocator::Free(EruptAllocation& allocation)
+	{
+		if (!allocation.block) return;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		MemoryBlock& block = *allocation.block;
+		block.ranges.Free(allocation.offset);
+		block.allocationCount--;
+		allocation = EruptAllocation{};
+
+		if (block.allocationCount > 0) return;
+
+		// One empty block per memory type is kept, so a resource that is recreated repeatedly does not reallocate it
+		const bool spare = std::any_of(m_Blocks.begin(), m_Blocks.end(), [&](const std::unique_ptr<MemoryBlock>& other)
+		{
+			return other.get() != &block && !other->dedicated && other->allocationCount == 0 &&
+				other->memoryType == block.memoryType && other->linear == block.linear;
+		});
+
+		if (block.dedicated || spare)
+		{
+			DestroyBlock(block);
+			m_Blocks.erase(std::find_if(m_Blocks.begin(), m_Blocks.end(), [&](const std::unique_ptr<MemoryBlock>& other)
+			{
+				return other.get() == &block;
+			}));
+		}
+	}
+
+	VkMappedMemoryRange EruptAllocator::GetMappedRange(const EruptAllocation& allocation, VkDeviceSize size, VkDeviceSize offset) const
+	{
+		assert(allocation.block && offset <= allocation.size && "Range outside of the allocation!");
+
+		if (size == VK_WHOLE_SIZE)
+		{
+			size = allocation.size - offset;
+		}
+
+		const VkDeviceSize begin = (allocation.offset + offset) / m_NonCoherentAtomSize * m_NonCoherentAtomSize;
+		const VkDeviceSize end = std::min(
+			(allocation.offset + offset + size + m_NonCoherentAtomSize - 1) / m_NonCoherentAtomSize * m_NonCoherentAtomSize,
+			allocation.block->size);
+
+		VkMappedMemoryRange range{};
+		range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+		range.memory = allocation.memory;
+		range.offset = begin;
+		range.size = end - begin;
+		return range;
+	}
+
+	EruptAllocator::Statistics EruptAllocator::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		Statistics statistics{};
+		for (const auto& block : m_Blocks)
+		{
+			statistics.blockCount++;
+			statistics.dedicatedBlockCount += block->dedicated ? 1 : 0;
+			statistics.allocationCount += block->allocationCount;
+			statistics.reservedBytes += block->size;
+			statistics.usedBytes += block->ranges.GetUsed();
+		}
+		return statistics;
+	}
+
+	uint32_t EruptAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+	{
+		for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; i++)
+		{
+			if ((typeFilter & (1 << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			{
+				return i;
+			}
+		}
+
+		ERUPT_CORE_ERROR("Failed to find suitable memory type!");
+		throw std::runtime_error("Failed to find suitable memory type!");
+	}
+
+	MemoryBlock& EruptAllocator::CreateBlock(uint32_t memoryType, bool linear, VkDeviceSize size, bool dedicated)
+	{
+		auto block = std::make_unique<MemoryBlock>();
+		block->size = size;
+		block->memoryType = memoryType;
+		block->linear = linear;
+		block->dedicated = dedicated;
+		block->ranges = RangeAllocator{ size };
+
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryType;
+
+		if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &block->memory) != VK_SUCCESS)
+		{
+			ERUPT_CORE_ERROR("Failed to allocate {0} bytes of memory type {1}!", size, memoryType);
+			throw std::runtime_error("Failed to allocate device memory!");
+		}
+
+		if (m_MemoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+		{
+			if (vkMapMemory(m_Device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped) != VK_SUCCESS)
+			{
+				vkFreeMemory(m_Device, block->memory, nullptr);
+				ERUPT_CORE_ERROR("Failed to map memory type {0}!", memoryType);
+				throw std::runtime_error("Failed to map device memory!");
+			}
+		}
+
+		if (!dedicated)
+		{
+			ERUPT_CORE_INFO("Allocated a {0:.1f} MiB block of memory type {1}", size / 1048576.0, memoryType);
+		}
+
+		m_Blocks.push_back(std::move(block));
+		return *m_Blocks.back();
+	}
+
+	void EruptAllocator::DestroyBlock(MemoryBlock& block)
+	{
+		if (block.mapped)
+		{
+			vkUnmapMemory(m_Device, block.memory);
+		}
+		vkFreeMemory(m_Device, block.memory, nullptr);
+	}
+}
@@ -36,14 +36,14 @@ namespace Erupt
 	{
 		m_AlignmentSize = GetAlignment(instanceSize, minOffsetAlignment);
 		m_BufferSize = m_AlignmentSize * instanceCount;
-		device.CreateBuffer(m_BufferSize, usageFlags, memoryPropertyFlags, m_Buffer, m_Memory);
+		device.CreateBuffer(m_BufferSize, usageFlags, memoryPropertyFlags, m_Buffer, m_Allocation);
 	}
 
 	EruptBuffer::~EruptBuffer()
 	{
 		Unmap();
 		vkDestroyBuffer(m_Device.Device(), m_Buffer, nullptr);
-		vkFreeMemory(m_Device.Device(), m_Memory, nullptr);
+		m_Device.GetAllocator().Free(m_Allocation);
 	}
 	
 	/*
@@ -57,22 +57,26 @@ namespace Erupt
 	*/
 	VkResult EruptBuffer::Map(VkDeviceSize size, VkDeviceSize offset)
 	{
-		assert(m_Buffer && m_Memory && "Called map on buffer before create");
-		return vkMapMemory(m_Device.Device(), m_Memory, offset, size, 0, &m_Mapped);
+		assert(m_Buffer && m_Allocation.memory && "Called map on buffer before create");
+
+		// Host visible memory stays mapped by the allocator, the block may be shared with other buffers
+		if (!m_Allocation.mapped)
+		{
+			return VK_ERROR_MEMORY_MAP_FAILED;
+		}
+
+		m_Mapped = static_cast<char*>(m_Allocation.mapped) + offset;
+		return VK_SUCCESS;
 	}
 	
 	/*
 		Unmap a mapped memory range
 
-		@note Does not return a result as vkUnmapMemory can't fail
+		@note The memory itself stays mapped until the allocator releases its block
 	*/
 	void EruptBuffer::Unmap()
 	{
-		if (m_Mapped)
-		{
-			vkUnmapMemory(m_Device.Device(), m_Memory);
-			m_Mapped = nullptr;
-		}
+		m_Mapped = nullptr;
 	}
 	
 	/*
@@ -111,11 +115,7 @@ namespace Erupt
 	*/
 	VkResult EruptBuffer::Flush(VkDeviceSize size, VkDeviceSize offset)
 	{
-		VkMappedMemoryRange mappedRange = {};
-		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		mappedRange.memory = m_Memory;
-		mappedRange.offset = offset;
-		mappedRange.size = size;
+		const VkMappedMemoryRange mappedRange = m_Device.GetAllocator().GetMappedRange(m_Allocation, size, offset);
 		return vkFlushMappedMemoryRanges(m_Device.Device(), 1, &mappedRange);
 	}
 	
@@ -149,11 +149,7 @@ namespace Erupt
 	*/
 	VkResult EruptBuffer::Invalidate(VkDeviceSize size, VkDeviceSize offset)
 	{
-		VkMappedMemoryRange mappedRange = {};
-		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-		mappedRange.memory = m_Memory;
-		mappedRange.offset = offset;
-		mappedRange.size = size;
+		const VkMappedMemoryRange mappedRange = m_Device.GetAllocator().GetMappedRange(m_Allocation, size, offset);
 		return vkInvalidateMappedMemoryRanges(m_Device.Device(), 1, &mappedRange);
 	}
 	
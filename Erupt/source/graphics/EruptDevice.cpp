@@ -1,4 +1,7 @@
 #include "graphics/EruptDevice.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/StagingRing.h"
+#include "graphics/UploadQueue.h"
 
 #include "core/Log.h"
 
@@ -54,13 +57,18 @@ namespace Erupt {
 	}
 
 	// class member functions
-	EruptDevice::EruptDevice(Window& window) : m_Window(window)
+	EruptDevice::EruptDevice(Window& window, VkDeviceSize stagingCapacity) : m_Window(window), m_StagingCapacity(stagingCapacity)
 	{
 		Init();
 	}
 
 	EruptDevice::~EruptDevice() 
 	{
+		m_UploadQueue.reset();
+		m_GeometryPool.reset();
+		m_StagingRing.reset();
+		m_Allocator.reset();
+
 		vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
 		vkDestroyDevice(m_Device, nullptr);
 
@@ -81,6 +89,11 @@ namespace Erupt {
 		PickPhysicalDevice();
 		CreateLogicalDevice();
 		CreateCommandPool();
+
+		m_Allocator = std::make_unique<EruptAllocator>(m_Device, m_PhysicalDevice);
+		m_StagingRing = std::make_unique<StagingRing>(*this, m_StagingCapacity);
+		m_UploadQueue = std::make_unique<UploadQueue>(*this);
+		m_GeometryPool = std::make_unique<GeometryPool>(*this);
 	}
 
 	void EruptDevice::CreateInstance() 
@@ -165,6 +178,10 @@ namespace Erupt {
 
 		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 		std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily, indices.presentFamily };
+		if (indices.transferFamilyHasValue)
+		{
+			uniqueQueueFamilies.insert(indices.transferFamily);
+		}
 
 		float queuePriority = 1.0f;
 		for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -208,6 +225,17 @@ namespace Erupt {
 
 		vkGetDeviceQueue(m_Device, indices.graphicsFamily, 0, &m_GraphicsQueue);
 		vkGetDeviceQueue(m_Device, indices.presentFamily, 0, &m_PresentQueue);
+
+		if (indices.transferFamilyHasValue)
+		{
+			vkGetDeviceQueue(m_Device, indices.transferFamily, 0, &m_TransferQueue);
+			ERUPT_CORE_INFO("Uploads use the transfer queue family {0}", indices.transferFamily);
+		}
+		else
+		{
+			m_TransferQueue = m_GraphicsQueue;
+			ERUPT_CORE_INFO("No transfer queue family, uploads share the graphics queue");
+		}
 	}
 
 	void EruptDevice::CreateCommandPool()
@@ -404,6 +432,28 @@ namespace Erupt {
 			i++;
 		}
 
+		// Uploads overlap with rendering on a family without graphics. Transfer only families are usually
+		// dedicated copy engines, so they are preferred over compute families
+		for (uint32_t family = 0; family < queueFamilyCount; family++)
+		{
+			const VkQueueFlags flags = queueFamilies[family].queueFlags;
+			if (queueFamilies[family].queueCount == 0 || (flags & VK_QUEUE_GRAPHICS_BIT) || !(flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_COMPUTE_BIT)))
+			{
+				continue;
+			}
+
+			const bool transferOnly = !(flags & VK_QUEUE_COMPUTE_BIT);
+			if (!indices.transferFamilyHasValue || transferOnly)
+			{
+				indices.transferFamily = family;
+				indices.transferFamilyHasValue = true;
+			}
+			if (transferOnly)
+			{
+				break;
+			}
+		}
+
 		return indices;
 	}
 
@@ -477,7 +527,7 @@ namespace Erupt {
 		VkBufferUsageFlags usage,
 		VkMemoryPropertyFlags properties,
 		VkBuffer& buffer,
-		VkDeviceMemory& bufferMemory) 
+		EruptAllocation& bufferMemory) 
 	{
 		VkBufferCreateInfo bufferInfo{};
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -493,17 +543,12 @@ namespace Erupt {
 		VkMemoryRequirements memRequirements;
 		vkGetBufferMemoryRequirements(m_Device, buffer, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
+		bufferMemory = m_Allocator->Allocate(memRequirements, properties, true);
 
-		if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
+		if (vkBindBufferMemory(m_Device, buffer, bufferMemory.memory, bufferMemory.offset) != VK_SUCCESS)
 		{
-			throw std::runtime_error("failed to allocate vertex buffer memory!");
+			throw std::runtime_error("failed to bind buffer memory!");
 		}
-
-		vkBindBufferMemory(m_Device, buffer, bufferMemory, 0);
 	}
 
 	VkCommandBuffer EruptDevice::BeginSingleTimeCommands() 
@@ -540,13 +585,13 @@ namespace Erupt {
 		vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &commandBuffer);
 	}
 
-	void EruptDevice::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) 
+	void EruptDevice::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset) 
 	{
 		VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
 
 		VkBufferCopy copyRegion{};
-		copyRegion.srcOffset = 0;  // Optional
-		copyRegion.dstOffset = 0;  // Optional
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
 		copyRegion.size = size;
 		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 
@@ -585,7 +630,7 @@ namespace Erupt {
 		const VkImageCreateInfo& imageInfo,
 		VkMemoryPropertyFlags properties,
 		VkImage& image,
-		VkDeviceMemory& imageMemory)
+		EruptAllocation& imageMemory)
 	{
 		if (vkCreateImage(m_Device, &imageInfo, nullptr, &image) != VK_SUCCESS) 
 		{
@@ -595,17 +640,9 @@ namespace Erupt {
 		VkMemoryRequirements memRequirements;
 		vkGetImageMemoryRequirements(m_Device, image, &memRequirements);
 
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(m_Device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-		{
-			throw std::runtime_error("failed to allocate image memory!");
-		}
+		imageMemory = m_Allocator->Allocate(memRequirements, properties, imageInfo.tiling == VK_IMAGE_TILING_LINEAR);
 
-		if (vkBindImageMemory(m_Device, image, imageMemory, 0) != VK_SUCCESS) 
+		if (vkBindImageMemory(m_Device, image, imageMemory.memory, imageMemory.offset) != VK_SUCCESS) 
 		{
 			throw std::runtime_error("failed to bind image memory!");
 		}
@@ -1,4 +1,6 @@
 #include "graphics/EruptRenderer.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/UploadQueue.h"
 
 #include "core/FileIO.h"
 
@@ -22,12 +24,16 @@ namespace Erupt
 	{
 		RecreateSwapchain();
 		CreateCommandBuffers();
+		m_FrameAllocator = std::make_unique<FrameAllocator>(m_EruptDevice);
 	}
 
 	VkCommandBuffer EruptRenderer::BeginFrame()
 	{
 		assert(!m_IsFrameStarted && "Cannot call BeginFrame while already in progress");
 
+		// Uploads recorded since the last frame execute ahead of it
+		m_EruptDevice.GetUploadQueue().Update();
+
 		auto result = m_EruptSwapChain->AcquireNextImage(&m_CurrentImageIndex);
 
 		// Occurs when window is resized
@@ -45,6 +51,10 @@ namespace Erupt
 
 		m_IsFrameStarted = true;
 
+		// Acquiring the image waited for the previous frame in this slot, geometry and frame data it used can be reused now
+		m_EruptDevice.GetGeometryPool().NextFrame();
+		m_FrameAllocator->BeginFrame(m_CurrentFrameIndex);
+
 		auto commandBuffer = GetCurrentCommandBuffer();
 
 		VkCommandBufferBeginInfo beginInfo{};
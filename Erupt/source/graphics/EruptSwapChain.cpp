@@ -57,7 +57,7 @@ namespace Erupt
 		{
 			vkDestroyImageView(m_Device.Device(), m_DepthImageViews[i], nullptr);
 			vkDestroyImage(m_Device.Device(), m_DepthImages[i], nullptr);
-			vkFreeMemory(m_Device.Device(), m_DepthImageMemorys[i], nullptr);
+			m_Device.GetAllocator().Free(m_DepthImageMemorys[i]);
 		}
 
 		for (auto framebuffer : m_SwapChainFramebuffers)
@@ -0,0 +1,68 @@
+#include "graphics/FrameAllocator.h"
+#include "graphics/EruptSwapChain.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace Erupt
+{
+	FrameAllocator::FrameAllocator(EruptDevice& device, VkDeviceSize frameCapacity)
+	{
+		// Both limits are powers of two, the larger one satisfies the other
+		const VkPhysicalDeviceLimits& limits = device.properties.limits;
+		m_Alignment = std::max<VkDeviceSize>({ limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment, 1 });
+		m_FrameCapacity = (frameCapacity + m_Alignment - 1) & ~(m_Alignment - 1);
+
+		m_Buffer = std::make_unique<EruptBuffer>
+		(
+			device,
+			m_FrameCapacity,
+			EruptSwapChain::MAX_FRAMES_IN_FLIGHT,
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			m_Alignment
+		);
+		m_Buffer->Map();
+
+		// Dynamic offsets are 32 bit
+		assert(m_Buffer->GetBufferSize() <= UINT32_MAX && "Frame allocator too large for dynamic offsets!");
+	}
+
+	void FrameAllocator::BeginFrame(int frameIndex)
+	{
+		assert(frameIndex >= 0 && frameIndex < EruptSwapChain::MAX_FRAMES_IN_FLIGHT && "Invalid frame index!");
+
+		m_FrameBegin = frameIndex * m_Buffer->GetAlignmentSize();
+		m_Head = m_FrameBegin;
+	}
+
+	FrameAllocation FrameAllocator::Allocate(VkDeviceSize size)
+	{
+		assert(size > 0 && "Cannot allocate 0 bytes!");
+
+		const VkDeviceSize alignedSize = (size + m_Alignment - 1) & ~(m_Alignment - 1);
+
+		if (m_Head + alignedSize > m_FrameBegin + m_FrameCapacity)
+		{
+			ERUPT_CORE_ERROR("Frame allocator out of memory, {0} of {1} bytes used this frame!", GetFrameUsage(), m_FrameCapacity);
+			throw std::runtime_error("Frame allocator out of memory!");
+		}
+
+		FrameAllocation allocation{};
+		allocation.buffer = m_Buffer->GetBuffer();
+		allocation.offset = m_Head;
+		allocation.size = size;
+		allocation.mapped = static_cast<char*>(m_Buffer->GetMappedMemory()) + m_Head;
+
+		m_Head += alignedSize;
+		return allocation;
+	}
+
+	VkDescriptorBufferInfo FrameAllocator::DescriptorInfo(VkDeviceSize range) const
+	{
+		return VkDescriptorBufferInfo{ m_Buffer->GetBuffer(), 0, range };
+	}
+}
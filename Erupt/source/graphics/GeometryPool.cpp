@@ -0,0 +1,151 @@
+#include "graphics/GeometryPool.h"
+#include "graphics/EruptSwapChain.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+namespace Erupt
+{
+	GeometryPool::GeometryPool(EruptDevice& device, VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity)
+		: m_Device(device),
+		m_Vertices{ "vertex", VK_BUFFER_USAGE_VERTEX_BUFFER_BIT },
+		m_Indices{ "index", VK_BUFFER_USAGE_INDEX_BUFFER_BIT }
+	{
+		CreateHeap(m_Vertices, vertexCapacity);
+		CreateHeap(m_Indices, indexCapacity);
+	}
+
+	GeometryPool::~GeometryPool()
+	{
+	}
+
+	VkDeviceSize GeometryPool::UploadVertices(VkBuffer stagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size, VkDeviceSize stride)
+	{
+		return Upload(m_Vertices, stagingBuffer, stagingOffset, size, stride);
+	}
+
+	VkDeviceSize GeometryPool::UploadIndices(VkBuffer stagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size)
+	{
+		return Upload(m_Indices, stagingBuffer, stagingOffset, size, sizeof(uint32_t));
+	}
+
+	void GeometryPool::FreeVertices(VkDeviceSize offset)
+	{
+		m_Vertices.pendingFrees.push_back({ offset, m_Frame });
+	}
+
+	void GeometryPool::FreeIndices(VkDeviceSize offset)
+	{
+		m_Indices.pendingFrees.push_back({ offset, m_Frame });
+	}
+
+	void GeometryPool::NextFrame()
+	{
+		m_Frame++;
+
+		// Starting a frame waited for the one that used the same frame slot, every frame before it is done
+		if (m_Frame > EruptSwapChain::MAX_FRAMES_IN_FLIGHT)
+		{
+			const uint64_t completedFrame = m_Frame - EruptSwapChain::MAX_FRAMES_IN_FLIGHT;
+			ReleasePendingFrees(m_Vertices, completedFrame);
+			ReleasePendingFrees(m_Indices, completedFrame);
+			ReleaseRetiredBuffers(m_Vertices, completedFrame);
+			ReleaseRetiredBuffers(m_Indices, completedFrame);
+		}
+	}
+
+	void GeometryPool::BindVertexBuffer(VkCommandBuffer commandBuffer) const
+	{
+		VkBuffer buffers[] = { m_Vertices.buffer->GetBuffer() };
+		VkDeviceSize offsets[] = { 0 };
+
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+	}
+
+	void GeometryPool::BindIndexBuffer(VkCommandBuffer commandBuffer, VkIndexType indexType) const
+	{
+		vkCmdBindIndexBuffer(commandBuffer, m_Indices.buffer->GetBuffer(), 0, indexType);
+	}
+
+	void GeometryPool::CreateHeap(Heap& heap, VkDeviceSize capacity)
+	{
+		assert(capacity > 0 && capacity <= std::numeric_limits<uint32_t>::max() && "Invalid geometry pool capacity!");
+
+		heap.buffer = std::make_unique<EruptBuffer>
+		(
+			m_Device,
+			1,
+			static_cast<uint32_t>(capacity),
+			heap.usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		heap.allocator = RangeAllocator{ capacity };
+	}
+
+	VkDeviceSize GeometryPool::Upload(Heap& heap, VkBuffer stagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size, VkDeviceSize alignment)
+	{
+		UploadQueue& uploadQueue = m_Device.GetUploadQueue();
+		auto offset = heap.allocator.Allocate(size, alignment);
+
+		// Pending frees are left to NextFrame, reclaiming them now would mean waiting for the frames in flight
+		if (!offset)
+		{
+			// Ranges keep their offsets, so the used part is copied to the front of a larger buffer
+			const VkDeviceSize oldCapacity = heap.allocator.GetSize();
+			const VkDeviceSize usedExtent = heap.allocator.GetUsedExtent();
+			const VkDeviceSize newCapacity = std::max(oldCapacity * 2, usedExtent + size + alignment);
+
+			if (newCapacity > std::numeric_limits<uint32_t>::max())
+			{
+				ERUPT_CORE_ERROR("Geometry pool {0} buffer cannot grow beyond 4 GiB!", heap.name);
+				throw std::runtime_error("Geometry pool buffer cannot grow beyond 4 GiB!");
+			}
+
+			ERUPT_CORE_WARN("Geometry pool {0} buffer is full, growing it from {1:.1f} to {2:.1f} MiB", heap.name, oldCapacity / 1048576.0, newCapacity / 1048576.0);
+
+			std::unique_ptr<EruptBuffer> oldBuffer = std::move(heap.buffer);
+			RangeAllocator allocator = std::move(heap.allocator);
+			CreateHeap(heap, newCapacity);
+
+			// Ordered after the copies recorded into the old buffer, so ranges still uploading move along
+			if (usedExtent > 0)
+			{
+				uploadQueue.CopyUploadedBuffer(oldBuffer->GetBuffer(), heap.buffer->GetBuffer(), usedExtent);
+			}
+			heap.retiredBuffers.push_back({ std::move(oldBuffer), m_Frame, uploadQueue.GetTicket() });
+
+			allocator.Grow(newCapacity);
+			heap.allocator = std::move(allocator);
+			offset = heap.allocator.Allocate(size, alignment);
+			assert(offset && "Grown geometry pool buffer must fit the allocation!");
+		}
+
+		uploadQueue.CopyBuffer(stagingBuffer, heap.buffer->GetBuffer(), size, stagingOffset, *offset);
+		return *offset;
+	}
+
+	void GeometryPool::ReleasePendingFrees(Heap& heap, uint64_t completedFrame)
+	{
+		auto released = std::remove_if(heap.pendingFrees.begin(), heap.pendingFrees.end(), [&](const PendingFree& pending)
+		{
+			if (pending.frame > completedFrame) return false;
+
+			heap.allocator.Free(pending.offset);
+			return true;
+		});
+		heap.pendingFrees.erase(released, heap.pendingFrees.end());
+	}
+
+	void GeometryPool::ReleaseRetiredBuffers(Heap& heap, uint64_t completedFrame)
+	{
+		auto released = std::remove_if(heap.retiredBuffers.begin(), heap.retiredBuffers.end(), [&](const RetiredBuffer& retired)
+		{
+			return retired.frame <= completedFrame && m_Device.GetUploadQueue().IsComplete(retired.ticket);
+		});
+		heap.retiredBuffers.erase(released, heap.retiredBuffers.end());
+	}
+}
@@ -0,0 +1,219 @@
+#include "graphics/MeshCache.h"
+
+#include "core/Log.h"
+
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+namespace Erupt
+{
+	namespace
+	{
+		constexpr uint32_t MESH_MAGIC = 0x48534D45;	// "EMSH"
+		constexpr uint32_t MESH_VERSION = 3;
+
+		enum MeshFlags : uint32_t
+		{
+			MESH_OPTIMIZED = 1 << 0,	// went through Model::Builder::Optimize
+			MESH_LODS = 1 << 1,			// went through Model::Builder::GenerateLods
+			MESH_MESHLETS = 1 << 2,		// went through Model::Builder::BuildMeshlets
+		};
+
+		struct MeshHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t vertexStride;	// sizeof(Model::Vertex) when cooked, a layout change invalidates the cache
+			uint32_t vertexCount;
+			uint32_t indexCount;
+			uint32_t flags;			// MeshFlags
+			uint64_t sourceHash;
+			glm::vec3 boundsMin;
+			glm::vec3 boundsMax;
+			uint64_t vertexOffset;
+			uint64_t indexOffset;
+			uint32_t lodCount;
+			uint32_t meshletCount;
+			uint64_t lodOffset;
+			uint64_t meshletOffset;
+		};
+
+		uint32_t GetFlags(const Model::Builder& builder)
+		{
+			return (builder.optimize ? MESH_OPTIMIZED : 0) | (builder.generateLods ? MESH_LODS : 0) | (builder.buildMeshlets ? MESH_MESHLETS : 0);
+		}
+
+		// Word at a time multiplicative hash with a splitmix64 finalizer. Only used to detect changed sources,
+		// so it trades strength for hashing large files at memory speed
+		uint64_t HashBytes(const uint8_t* data, size_t size)
+		{
+			constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+
+			uint64_t hash = size * multiplier;
+			size_t i = 0;
+
+			for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				std::memcpy(&word, data + i, sizeof(word));
+				hash = (((hash << 5) | (hash >> 59)) ^ word) * multiplier;
+			}
+
+			if (i < size)
+			{
+				uint64_t word = 0;
+				std::memcpy(&word, data + i, size - i);
+				hash = (((hash << 5) | (hash >> 59)) ^ word) * multiplier;
+			}
+
+			hash ^= hash >> 30;
+			hash *= 0xBF58476D1CE4E5B9ull;
+			hash ^= hash >> 27;
+			hash *= 0x94D049BB133111EBull;
+			hash ^= hash >> 31;
+			return hash;
+		}
+	}
+
+	std::string MeshCache::GetCachePath(const std::string& sourcePath)
+	{
+		return std::filesystem::path(sourcePath).replace_extension(".emesh").string();
+	}
+
+	uint64_t MeshCache::HashSource(const std::string& sourcePath)
+	{
+		MappedFile source(sourcePath);
+		return HashBytes(source.Data(), source.Size());
+	}
+
+	std::shared_ptr<CookedMesh> MeshCache::Open(const std::string& sourcePath, std::optional<uint64_t> sourceHash, const Model::Builder& settings)
+	{
+		const std::string cachePath = GetCachePath(sourcePath);
+
+		if (!FileIO::Exists(cachePath))
+		{
+			return nullptr;
+		}
+
+		auto mesh = std::make_shared<CookedMesh>(cachePath);
+		const MappedFile& file = mesh->file;
+
+		if (file.Size() < sizeof(MeshHeader))
+		{
+			ERUPT_CORE_WARN("Cooked mesh {0} is truncated, re-cooking", cachePath);
+			return nullptr;
+		}
+
+		MeshHeader header;
+		std::memcpy(&header, file.Data(), sizeof(header));
+
+		if (header.magic != MESH_MAGIC || header.version != MESH_VERSION || header.vertexStride != sizeof(Model::Vertex))
+		{
+			ERUPT_CORE_INFO("Cooked mesh {0} has an outdated format, re-cooking", cachePath);
+			return nullptr;
+		}
+
+		if (sourceHash.has_value() && header.sourceHash != *sourceHash)
+		{
+			return nullptr;
+		}
+
+		// A shipped cooked mesh without its source cannot be re-cooked, so it is used either way
+		if (sourceHash.has_value() && header.flags != GetFlags(settings))
+		{
+			return nullptr;
+		}
+
+		const uint64_t vertexBytes = uint64_t(header.vertexCount) * sizeof(Model::Vertex);
+		const uint64_t indexBytes = uint64_t(header.indexCount) * sizeof(uint32_t);
+		const uint64_t lodBytes = uint64_t(header.lodCount) * sizeof(Model::Lod);
+		const uint64_t meshletBytes = uint64_t(header.meshletCount) * sizeof(Model::Meshlet);
+
+		if (header.vertexOffset > file.Size() || vertexBytes > file.Size() - header.vertexOffset ||
+			header.indexOffset > file.Size() || indexBytes > file.Size() - header.indexOffset ||
+			header.lodOffset > file.Size() || lodBytes > file.Size() - header.lodOffset ||
+			header.meshletOffset > file.Size() || meshletBytes > file.Size() - header.meshletOffset ||
+			header.vertexOffset % alignof(Model::Vertex) != 0 || header.indexOffset % alignof(uint32_t) != 0 ||
+			header.lodOffset % alignof(Model::Lod) != 0 || header.meshletOffset % alignof(Model::Meshlet) != 0)
+		{
+			ERUPT_CORE_WARN("Cooked mesh {0} is corrupt, re-cooking", cachePath);
+			return nullptr;
+		}
+
+		mesh->vertices = reinterpret_cast<const Model::Vertex*>(file.Data() + header.vertexOffset);
+		mesh->vertexCount = header.vertexCount;
+		mesh->indices = reinterpret_cast<const uint32_t*>(file.Data() + header.indexOffset);
+		mesh->indexCount = header.indexCount;
+		mesh->lods = reinterpret_cast<const Model::Lod*>(file.Data() + header.lodOffset);
+		mesh->lodCount = header.lodCount;
+		mesh->meshlets = reinterpret_cast<const Model::Meshlet*>(file.Data() + header.meshletOffset);
+		mesh->meshletCount = header.meshletCount;
+		mesh->bounds = { header.boundsMin, header.boundsMax };
+
+		return mesh;
+	}
+
+	void MeshCache::Write(const std::string& sourcePath, uint64_t sourceHash, const Model::Builder& builder)
+	{
+		const std::string cachePath = GetCachePath(sourcePath);
+
+		const size_t vertexBytes = builder.vertices.size() * sizeof(Model::Vertex);
+		const size_t indexBytes = builder.indices.size() * sizeof(uint32_t);
+		const size_t lodBytes = builder.lods.size() * sizeof(Model::Lod);
+		const size_t meshletBytes = builder.meshlets.size() * sizeof(Model::Meshlet);
+
+		MeshHeader header{};
+		header.magic = MESH_MAGIC;
+		header.version = MESH_VERSION;
+		header.vertexStride = sizeof(Model::Vertex);
+		header.vertexCount = static_cast<uint32_t>(builder.vertices.size());
+		header.indexCount = static_cast<uint32_t>(builder.indices.size());
+		header.flags = GetFlags(builder);
+		header.sourceHash = sourceHash;
+		header.boundsMin = builder.bounds.min;
+		header.boundsMax = builder.bounds.max;
+		header.vertexOffset = sizeof(MeshHeader);
+		header.indexOffset = header.vertexOffset + vertexBytes;
+		header.lodCount = static_cast<uint32_t>(builder.lods.size());
+		header.lodOffset = header.indexOffset + indexBytes;
+		header.meshletCount = static_cast<uint32_t>(builder.meshlets.size());
+		header.meshletOffset = header.lodOffset + lodBytes;
+
+		std::vector<char> data(header.meshletOffset + meshletBytes);
+		std::memcpy(data.data(), &header, sizeof(header));
+		if (vertexBytes > 0)
+		{
+			std::memcpy(data.data() + header.vertexOffset, builder.vertices.data(), vertexBytes);
+		}
+		if (indexBytes > 0)
+		{
+			std::memcpy(data.data() + header.indexOffset, builder.indices.data(), indexBytes);
+		}
+		if (lodBytes > 0)
+		{
+			std::memcpy(data.data() + header.lodOffset, builder.lods.data(), lodBytes);
+		}
+		if (meshletBytes > 0)
+		{
+			std::memcpy(data.data() + header.meshletOffset, builder.meshlets.data(), meshletBytes);
+		}
+
+		// Written to a per thread temporary and renamed, so a concurrent load never maps a half written file
+		const std::string tempPath = cachePath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+
+		try
+		{
+			FileIO::WriteBinaryFile(data, tempPath);
+			std::filesystem::rename(FileIO::GetResourcesPath() + tempPath, FileIO::GetResourcesPath() + cachePath);
+		}
+		catch (const std::exception& e)
+		{
+			ERUPT_CORE_WARN("Failed to write cooked mesh {0}: {1}", cachePath, e.what());
+
+			std::error_code error;
+			std::filesystem::remove(FileIO::GetResourcesPath() + tempPath, error);
+		}
+	}
+}
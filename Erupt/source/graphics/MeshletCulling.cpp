@@ -0,0 +1,96 @@
+#include "graphics/MeshletCulling.h"
+
+#include <algorithm>
+
+namespace Erupt
+{
+	MeshletCulling::MeshletCulling(const glm::mat4& objectToClip, const glm::vec3& cameraPosition, bool cullBackfaces)
+		: m_CameraPosition(cameraPosition), m_CullBackfaces(cullBackfaces)
+	{
+		// Gribb and Hartmann plane extraction for a [0, 1] depth range, the planes point into the frustum
+		const glm::mat4 rows = glm::transpose(objectToClip);
+		m_Planes[0] = rows[3] + rows[0];	// left
+		m_Planes[1] = rows[3] - rows[0];	// right
+		m_Planes[2] = rows[3] + rows[1];	// top
+		m_Planes[3] = rows[3] - rows[1];	// bottom
+		m_Planes[4] = rows[2];				// near
+		m_Planes[5] = rows[3] - rows[2];	// far
+
+		for (glm::vec4& plane : m_Planes)
+		{
+			const float length = glm::length(glm::vec3(plane));
+			if (length > 0.f)
+			{
+				plane /= length;
+			}
+		}
+	}
+
+	bool MeshletCulling::IsSphereVisible(const glm::vec3& center, float radius) const
+	{
+		for (const glm::vec4& plane : m_Planes)
+		{
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool MeshletCulling::IsMeshletVisible(const Model::Meshlet& meshlet) const
+	{
+		if (!IsSphereVisible(meshlet.center, meshlet.radius))
+		{
+			return false;
+		}
+
+		// Back facing if the direction to every point of the sphere lies inside the inverted normal cone
+		if (m_CullBackfaces)
+		{
+			const glm::vec3 toCenter = meshlet.center - m_CameraPosition;
+			if (glm::dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool MeshletCulling::CullModel(const Model& model, uint32_t lod, std::vector<Model::IndexRange>& ranges) const
+	{
+		const Model::Bounds& bounds = model.GetBounds();
+		if (!IsSphereVisible((bounds.min + bounds.max) * 0.5f, glm::length(bounds.max - bounds.min) * 0.5f))
+		{
+			return false;
+		}
+
+		const std::vector<Model::Lod>& lods = model.GetLods();
+		const Model::Lod& level = lods[std::min<size_t>(lod, lods.size() - 1)];
+		if (level.meshletCount == 0)
+		{
+			return true;
+		}
+
+		const std::vector<Model::Meshlet>& meshlets = model.GetMeshlets();
+		const size_t firstRange = ranges.size();
+
+		for (uint32_t i = level.firstMeshlet; i < level.firstMeshlet + level.meshletCount; i++)
+		{
+			const Model::Meshlet& meshlet = meshlets[i];
+			if (!IsMeshletVisible(meshlet)) continue;
+
+			if (ranges.size() > firstRange && ranges.back().firstIndex + ranges.back().indexCount == meshlet.firstIndex)
+			{
+				ranges.back().indexCount += meshlet.indexCount;
+			}
+			else
+			{
+				ranges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+			}
+		}
+
+		return ranges.size() > firstRange;
+	}
+}
@@ -1,118 +1,279 @@
 #include "graphics/Model.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/MeshCache.h"
+#include "graphics/mesh/MeshOptimizer.h"
+#include "graphics/mesh/MeshSimplifier.h"
+#include "graphics/mesh/MeshletBuilder.h"
+#include "graphics/mesh/ObjParser.h"
+#include "graphics/mesh/VertexPacking.h"
+#include "graphics/mesh/VertexWelder.h"
 
 #include "core/Log.h"
 #include "core/FileIO.h"
-
-#include "EruptUtils.h"
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include "core/JobSystem.h"
 
 #include <cassert>
 #include <cstring>
-#include <unordered_map>
+#include <limits>
 
 #define TINYOBJLOADER_IMPLEMENTATION 
 #include "tiny_obj_loader.h"
 
-namespace std
+namespace Erupt
 {
-	template <>
-	struct hash<Erupt::Model::Vertex>
+	namespace
 	{
-		size_t operator()(Erupt::Model::Vertex const& vertex) const
+		// Coarser levels are not generated below this many triangles
+		constexpr size_t MIN_LOD_TRIANGLES = 64;
+
+		// A level that removes less than this fraction of the previous level's triangles ends the lod chain
+		constexpr float MIN_LOD_REDUCTION = 0.1f;
+
+		// Error budget of the whole lod chain, as a fraction of the bounding box diagonal. Meshes that cannot be halved
+		// within it anymore (e.g. thin features and high valence fans) end their chain instead of collapsing into slivers
+		constexpr float MAX_LOD_ERROR = 0.02f;
+
+		// Fallback for files ObjParser does not handle, produces the same corner stream
+		void ReadCornersWithTinyObj(const std::string& filepath, std::vector<Model::Vertex>& corners)
 		{
-			size_t seed = 0;
-			Erupt::HashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
-			return seed;
+			tinyobj::attrib_t attrib;
+			std::vector<tinyobj::shape_t> shapes;
+			std::vector<tinyobj::material_t> materials;
+			std::string warn, err;
+
+			const std::string fullPath = FileIO::GetResourcesPath() + filepath;
+
+			if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, fullPath.c_str()))
+			{
+				ERUPT_CORE_ERROR("{0} {1}", warn, err);
+				throw std::runtime_error(warn + err);
+			}
+
+			size_t cornerCount = 0;
+			for (const auto& shape : shapes)
+			{
+				cornerCount += shape.mesh.indices.size();
+			}
+
+			corners.clear();
+			corners.reserve(cornerCount);
+
+			for (const auto& shape : shapes)
+			{
+				for (const auto& index : shape.mesh.indices)
+				{
+					Model::Vertex& vertex = corners.emplace_back();
+
+					if (index.vertex_index >= 0)
+					{
+						vertex.position =
+						{
+							attrib.vertices[3 * index.vertex_index + 0],
+							attrib.vertices[3 * index.vertex_index + 1],
+							attrib.vertices[3 * index.vertex_index + 2]
+						};
+
+						vertex.color =
+						{
+							attrib.colors[3 * index.vertex_index + 0],
+							attrib.colors[3 * index.vertex_index + 1],
+							attrib.colors[3 * index.vertex_index + 2]
+						};
+					}
+
+					if (index.normal_index >= 0)
+					{
+						vertex.normal =
+						{
+							attrib.normals[3 * index.normal_index + 0],
+							attrib.normals[3 * index.normal_index + 1],
+							attrib.normals[3 * index.normal_index + 2]
+						};
+					}
+
+					if (index.texcoord_index >= 0)
+					{
+						vertex.uv =
+						{
+							attrib.texcoords[2 * index.texcoord_index + 0],
+							attrib.texcoords[2 * index.texcoord_index + 1],
+						};
+					}
+				}
+			}
 		}
-	};
-}
+	}
 
-namespace Erupt
-{
 	Model::Model(EruptDevice& device, const Builder& builder)
-		: m_Device(device)
+		: Model(device, builder.filepath, builder.format)
+	{
+		Upload(builder);
+		m_Device.GetUploadQueue().Wait(m_UploadTicket);
+	}
+
+	Model::Model(EruptDevice& device, const std::string& filepath, VertexFormat format)
+		: m_Device(device), m_FilePath(filepath), m_Bounds{}, m_VertexFormat(format), m_PositionDecodeMatrix(1.f)
 	{
-		CreateVertexBuffers(builder.vertices);
-		CreateIndexBuffers(builder.indices);
 	}
 
 	Model::~Model()
 	{
+		// Nothing was uploaded for models that never finished loading
+		if (m_VertexCount == 0)
+		{
+			return;
+		}
+
+		GeometryPool& pool = m_Device.GetGeometryPool();
+
+		pool.FreeVertices(m_VertexBufferOffset);
+		if (m_IsIndexed)
+		{
+			pool.FreeIndices(m_IndexBufferOffset);
+		}
 	}
 
-	std::unique_ptr<Model> Model::CreateModelFromFile(EruptDevice& device, const std::string& filepath)
+	std::unique_ptr<Model> Model::CreateModelFromFile(EruptDevice& device, const std::string& filepath, VertexFormat format)
 	{
 		Builder builder{};
+		builder.format = format;
 		builder.LoadModel(filepath);
 
-		ERUPT_CORE_INFO("Vertex count: {0}", builder.vertices.size());
+		ERUPT_CORE_INFO("Vertex count: {0}", builder.GetVertexCount());
 
 		return std::make_unique<Model>(device, builder);
 	}
 
+	std::vector<std::unique_ptr<Model>> Model::CreateModelsFromFiles(EruptDevice& device, const std::vector<std::string>& filepaths, const std::vector<VertexFormat>& formats)
+	{
+		assert((formats.empty() || formats.size() == filepaths.size()) && "Expected one vertex format per file");
+
+		std::vector<Builder> builders(filepaths.size());
+		for (size_t i = 0; i < formats.size(); i++)
+		{
+			builders[i].format = formats[i];
+		}
+
+		JobSystem::ParallelFor(filepaths.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				builders[i].LoadModel(filepaths[i]);
+			}
+		});
+
+		std::vector<std::unique_ptr<Model>> models;
+		models.reserve(filepaths.size());
+
+		// All copies go into one batch, which is waited for once
+		for (size_t i = 0; i < builders.size(); i++)
+		{
+			ERUPT_CORE_INFO("Vertex count: {0}", builders[i].GetVertexCount());
+			models.push_back(std::unique_ptr<Model>(new Model(device, builders[i].filepath, builders[i].format)));
+			models.back()->Upload(builders[i]);
+		}
+
+		UploadQueue& uploads = device.GetUploadQueue();
+		uploads.Wait(uploads.GetTicket());
+
+		return models;
+	}
+
+	void Model::Upload(const Builder& builder)
+	{
+		assert(builder.format == m_VertexFormat && "Builder does not match the model!");
+
+		m_Bounds = builder.bounds;
+		m_PositionDecodeMatrix = VertexPacking::GetPositionDecodeMatrix(m_VertexFormat, m_Bounds);
+
+		CreateVertexBuffers(builder.GetVertexData(), builder.GetVertexCount());
+		CreateIndexBuffers(builder.GetIndexData(), builder.GetIndexCount());
+		CreateLods(builder.GetLodData(), builder.GetLodCount());
+		CreateMeshlets(builder.GetMeshletData(), builder.GetMeshletCount());
+
+		m_UploadTicket = m_Device.GetUploadQueue().GetTicket();
+	}
+
+	bool Model::IsReady() const
+	{
+		return m_VertexCount > 0 && m_Device.GetUploadQueue().IsComplete(m_UploadTicket);
+	}
+
+	size_t Model::GetCpuMemoryUsage() const
+	{
+		return sizeof(Model) + m_FilePath.capacity() + m_Lods.capacity() * sizeof(Lod) + m_Meshlets.capacity() * sizeof(Meshlet);
+	}
+
+	size_t Model::GetGpuMemoryUsage() const
+	{
+		const size_t vertexSize = m_VertexFormat != VertexFormat::Full ? sizeof(PackedVertex) : sizeof(Vertex);
+		const size_t indexSize = m_IndexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+		return size_t(m_VertexCount) * vertexSize + (m_IsIndexed ? size_t(m_IndexCount) * indexSize : 0);
+	}
+
 	void Model::Bind(VkCommandBuffer commandBuffer)
 	{
-		VkBuffer buffers[] = { m_VertexBuffer->GetBuffer()};
-		VkDeviceSize offsets[] = { 0 };
+		const GeometryPool& pool = m_Device.GetGeometryPool();
 
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+		pool.BindVertexBuffer(commandBuffer);
 
 		if (m_IsIndexed)
 		{
-			vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+			pool.BindIndexBuffer(commandBuffer, m_IndexType);
 		}
 	}
 
-	void Model::Draw(VkCommandBuffer commandBuffer)
+	void Model::Draw(VkCommandBuffer commandBuffer, uint32_t lod)
 	{
 		if (m_IsIndexed)
 		{
-			vkCmdDrawIndexed(commandBuffer, m_IndexCount, 1, 0, 0, 0);
+			const Lod& range = m_Lods[std::min<size_t>(lod, m_Lods.size() - 1)];
+			vkCmdDrawIndexed(commandBuffer, range.indexCount, 1, m_FirstIndex + range.firstIndex, m_VertexOffset, 0);
 		}
 		else
 		{
-			vkCmdDraw(commandBuffer, m_VertexCount, 1, 0, 0);
+			vkCmdDraw(commandBuffer, m_VertexCount, 1, static_cast<uint32_t>(m_VertexOffset), 0);
 		}
 	}
 
-	void Model::CreateVertexBuffers(const std::vector<Vertex>& vertices)
+	void Model::DrawRange(VkCommandBuffer commandBuffer, const IndexRange& range)
 	{
-		m_VertexCount = static_cast<uint32_t>(vertices.size());
-		assert(m_VertexCount >= 3 && "Vertex count must be at least 3!");
+		assert(m_IsIndexed && uint64_t(range.firstIndex) + range.indexCount <= m_IndexCount && "Index range outside of the index buffer!");
 
-		VkDeviceSize bufferSize = sizeof(vertices[0]) * m_VertexCount;
+		vkCmdDrawIndexed(commandBuffer, range.indexCount, 1, m_FirstIndex + range.firstIndex, m_VertexOffset, 0);
+	}
 
-		uint32_t vertexSize = sizeof(vertices[0]);
+	void Model::CreateVertexBuffers(const Vertex* vertices, uint32_t vertexCount)
+	{
+		m_VertexCount = vertexCount;
+		assert(m_VertexCount >= 3 && "Vertex count must be at least 3!");
 
-		EruptBuffer stagingBuffer
-		{
-			m_Device,
-			vertexSize,
-			m_VertexCount,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		};
+		const bool packed = m_VertexFormat != VertexFormat::Full;
+		uint32_t vertexSize = packed ? sizeof(PackedVertex) : sizeof(Vertex);
 
-		stagingBuffer.Map();
-		stagingBuffer.WriteToBuffer((void*)vertices.data());
+		VkDeviceSize bufferSize = vertexSize * m_VertexCount;
 
-		m_VertexBuffer = std::make_unique<EruptBuffer>
-		(
-			m_Device,
-			vertexSize,
-			m_VertexCount,
-			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-		);
+		StagingRegion staging = m_Device.GetStagingRing().Allocate(bufferSize);
 
-		m_Device.CopyBuffer(stagingBuffer.GetBuffer(), m_VertexBuffer->GetBuffer(), bufferSize);
+		if (packed)
+		{
+			VertexPacking::Pack(vertices, m_VertexCount, m_VertexFormat, m_Bounds, static_cast<PackedVertex*>(staging.GetMappedMemory()));
+		}
+		else
+		{
+			memcpy(staging.GetMappedMemory(), vertices, bufferSize);
+		}
+
+		// Ranges are aligned to the vertex size, so the offset is a whole number of vertices
+		m_VertexBufferOffset = m_Device.GetGeometryPool().UploadVertices(staging.GetBuffer(), staging.GetOffset(), bufferSize, vertexSize);
+		m_Device.GetUploadQueue().Retain(std::move(staging));
+		m_VertexOffset = static_cast<int32_t>(m_VertexBufferOffset / vertexSize);
 	}
 
-	void Model::CreateIndexBuffers(const std::vector<uint32_t>& indices)
+	void Model::CreateIndexBuffers(const uint32_t* indices, uint32_t indexCount)
 	{
-		m_IndexCount = static_cast<uint32_t>(indices.size());
+		m_IndexCount = indexCount;
 		m_IsIndexed = m_IndexCount > 0;
 
 		if (!m_IsIndexed)
@@ -120,31 +281,58 @@ namespace Erupt
 			return;
 		}
 
-		VkDeviceSize bufferSize = sizeof(indices[0]) * m_IndexCount;
-		uint32_t indexSize = sizeof(indices[0]);
+		// 16 bit indices whenever every vertex can be addressed with them
+		const bool shortIndices = m_VertexCount <= 0x10000;
+		m_IndexType = shortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+		uint32_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+		VkDeviceSize bufferSize = indexSize * m_IndexCount;
+
+		StagingRegion staging = m_Device.GetStagingRing().Allocate(bufferSize);
+
+		if (shortIndices)
+		{
+			uint16_t* shortIndexData = static_cast<uint16_t*>(staging.GetMappedMemory());
+			for (uint32_t i = 0; i < m_IndexCount; i++)
+			{
+				shortIndexData[i] = static_cast<uint16_t>(indices[i]);
+			}
+		}
+		else
+		{
+			memcpy(staging.GetMappedMemory(), indices, bufferSize);
+		}
+
+		// Ranges are aligned to 4 bytes, a whole number of indices of either type
+		m_IndexBufferOffset = m_Device.GetGeometryPool().UploadIndices(staging.GetBuffer(), staging.GetOffset(), bufferSize);
+		m_Device.GetUploadQueue().Retain(std::move(staging));
+		m_FirstIndex = static_cast<uint32_t>(m_IndexBufferOffset / indexSize);
+	}
+
+	void Model::CreateLods(const Lod* lods, uint32_t lodCount)
+	{
+		if (lodCount == 0)
+		{
+			m_Lods = { Lod{ 0, m_IndexCount, 0.f } };
+			return;
+		}
+
+		m_Lods.assign(lods, lods + lodCount);
 
-		EruptBuffer stagingBuffer
+		for (const Lod& lod : m_Lods)
 		{
-			m_Device,
-			indexSize,
-			m_IndexCount,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		};
+			assert(uint64_t(lod.firstIndex) + lod.indexCount <= m_IndexCount && "Lod outside of the index buffer!");
+		}
+	}
 
-		stagingBuffer.Map();
-		stagingBuffer.WriteToBuffer((void*)indices.data());
-		
-		m_IndexBuffer = std::make_unique<EruptBuffer>
-		(
-			m_Device,
-			indexSize,
-			m_IndexCount,
-			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-		);
+	void Model::CreateMeshlets(const Meshlet* meshlets, uint32_t meshletCount)
+	{
+		m_Meshlets.assign(meshlets, meshlets + meshletCount);
 
-		m_Device.CopyBuffer(stagingBuffer.GetBuffer(), m_IndexBuffer->GetBuffer(), bufferSize);
+		for (const Lod& lod : m_Lods)
+		{
+			assert(uint64_t(lod.firstMeshlet) + lod.meshletCount <= m_Meshlets.size() && "Lod references missing meshlets!");
+		}
 	}
 
 	std::vector<VkVertexInputBindingDescription> Model::Vertex::GetBindingDescriptions()
@@ -173,75 +361,227 @@ namespace Erupt
 		return attributeDescriptions;
 	}
 
+	std::vector<VkVertexInputBindingDescription> Model::PackedVertex::GetBindingDescriptions()
+	{
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+		bindingDescriptions[0].binding = 0;
+		bindingDescriptions[0].stride = sizeof(PackedVertex);
+		bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		return bindingDescriptions;
+	}
+
+	std::vector<VkVertexInputAttributeDescription> Model::PackedVertex::GetAttributeDescriptions(VertexFormat format)
+	{
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+		// Position attribute, quantized positions are scaled into the bounds by the decode matrix
+		const VkFormat positionFormat = format == VertexFormat::PackedQuantized ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R16G16B16A16_SFLOAT;
+		attributeDescriptions.push_back({ 0, 0, positionFormat, offsetof(PackedVertex, position) });
+		// Color attribute
+		attributeDescriptions.push_back({ 1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, color) });
+		// Octahedral normal attribute
+		attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal) });
+		// Texture coordinate attribute
+		attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, uv) });
+
+		return attributeDescriptions;
+	}
+
+	std::vector<VkVertexInputBindingDescription> Model::GetBindingDescriptions(VertexFormat format)
+	{
+		return format == VertexFormat::Full ? Vertex::GetBindingDescriptions() : PackedVertex::GetBindingDescriptions();
+	}
+
+	std::vector<VkVertexInputAttributeDescription> Model::GetAttributeDescriptions(VertexFormat format)
+	{
+		return format == VertexFormat::Full ? Vertex::GetAttributeDescriptions() : PackedVertex::GetAttributeDescriptions(format);
+	}
+
 	void Model::Builder::LoadModel(const std::string& filepath)
 	{
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
+		this->filepath = filepath;
 
-		std::string fullPath = FileIO::GetResourcesPath() + filepath;
+		vertices.clear();
+		indices.clear();
+		lods.clear();
+		meshlets.clear();
+		cooked.reset();
+
+		// Without the source a shipped cooked mesh is used as is
+		const bool hasSource = FileIO::Exists(filepath);
+		const uint64_t sourceHash = hasSource ? MeshCache::HashSource(filepath) : 0;
 
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, fullPath.c_str()))
+		cooked = MeshCache::Open(filepath, hasSource ? std::optional<uint64_t>(sourceHash) : std::nullopt, *this);
+		if (cooked != nullptr)
 		{
-			ERUPT_CORE_ERROR("{0} {1}", warn, err);
-			throw std::runtime_error(warn + err);
+			bounds = cooked->bounds;
+			return;
 		}
 
-		vertices.clear();
-		indices.clear();
+		LoadObj(filepath);
+		if (optimize)
+		{
+			Optimize();
+		}
+		if (generateLods)
+		{
+			GenerateLods();
+		}
+		if (buildMeshlets)
+		{
+			BuildMeshlets();
+		}
+		ComputeBounds();
 
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+		MeshCache::Write(filepath, sourceHash, *this);
+	}
 
-		for (const auto& shape : shapes)
+	void Model::Builder::ComputeBounds()
+	{
+		if (vertices.empty())
 		{
-			for (const auto& index : shape.mesh.indices)
-			{
-				Vertex vertex{};
+			bounds = {};
+			return;
+		}
 
-				if (index.vertex_index >= 0)
-				{
-					vertex.position =
-					{
-						attrib.vertices[3 * index.vertex_index + 0],
-						attrib.vertices[3 * index.vertex_index + 1],
-						attrib.vertices[3 * index.vertex_index + 2]
-					};
+		bounds.min = glm::vec3(std::numeric_limits<float>::max());
+		bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
 
-					vertex.color =
-					{
-						attrib.colors[3 * index.vertex_index + 0],
-						attrib.colors[3 * index.vertex_index + 1],
-						attrib.colors[3 * index.vertex_index + 2]
-					};
-				}
+		for (const Vertex& vertex : vertices)
+		{
+			bounds.min = glm::min(bounds.min, vertex.position);
+			bounds.max = glm::max(bounds.max, vertex.position);
+		}
+	}
 
-				if (index.normal_index >= 0)
-				{
-					vertex.normal =
-					{
-						attrib.normals[3 * index.normal_index + 0],
-						attrib.normals[3 * index.normal_index + 1],
-						attrib.normals[3 * index.normal_index + 2]
-					};
-				}
+	void Model::Builder::Optimize()
+	{
+		assert(lods.empty() && "Optimize treats the index buffer as a single mesh and has to run before GenerateLods");
+		if (indices.empty()) return;
 
-				if (index.texcoord_index >= 0)
-				{
-					vertex.uv =
-					{
-						attrib.texcoords[2 * index.texcoord_index + 0],
-						attrib.texcoords[2 * index.texcoord_index + 1],
-					};
-				}
+		const VertexCacheStatistics before = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
 
-				if (uniqueVertices.count(vertex) == 0)
-				{
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-					vertices.push_back(vertex);
-				}
-				indices.push_back(uniqueVertices[vertex]);
-			}
+		std::vector<uint32_t> reordered(indices.size());
+		MeshOptimizer::OptimizeVertexCache(reordered.data(), indices.data(), indices.size(), vertices.size());
+		MeshOptimizer::OptimizeOverdraw(reordered, vertices);
+		MeshOptimizer::OptimizeVertexFetch(vertices, reordered);
+		indices = std::move(reordered);
+
+		const VertexCacheStatistics after = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+		ERUPT_CORE_INFO("Optimized {0}: ACMR {1:.3f} -> {2:.3f}, ATVR {3:.3f} -> {4:.3f}", filepath, before.acmr, after.acmr, before.atvr, after.atvr);
+	}
+
+	void Model::Builder::GenerateLods()
+	{
+		lods.clear();
+		if (indices.empty()) return;
+
+		lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.f });
+
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+		for (const Vertex& vertex : vertices)
+		{
+			min = glm::min(min, vertex.position);
+			max = glm::max(max, vertex.position);
+		}
+		const float maxError = glm::length(max - min) * MAX_LOD_ERROR;
+
+		std::vector<uint32_t> level(indices);
+		std::vector<uint32_t> simplified;
+		float error = 0.f;
+
+		while (lods.size() < MAX_LOD_COUNT)
+		{
+			const size_t targetIndexCount = level.size() / 6 * 3;
+			if (targetIndexCount / 3 < MIN_LOD_TRIANGLES) break;
+
+			// Every level is simplified from the previous one, so the errors add up
+			error += MeshSimplifier::Simplify(simplified, level.data(), level.size(), vertices, targetIndexCount, maxError - error);
+
+			if (simplified.size() > level.size() * (1.f - MIN_LOD_REDUCTION)) break;
+
+			level.resize(simplified.size());
+			MeshOptimizer::OptimizeVertexCache(level.data(), simplified.data(), simplified.size(), vertices.size());
+
+			lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(level.size()), error });
+			indices.insert(indices.end(), level.begin(), level.end());
+		}
+
+		ERUPT_CORE_INFO("Generated {0} lods for {1}: {2} -> {3} triangles, error {4}", lods.size(), filepath, lods.front().indexCount / 3, lods.back().indexCount / 3, lods.back().error);
+	}
+
+	void Model::Builder::BuildMeshlets()
+	{
+		meshlets.clear();
+		if (indices.empty()) return;
+
+		if (lods.empty())
+		{
+			lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.f });
+		}
+
+		for (Lod& lod : lods)
+		{
+			lod.firstMeshlet = static_cast<uint32_t>(meshlets.size());
+			MeshletBuilder::Build(indices, lod.firstIndex, lod.indexCount, vertices, meshlets);
+			lod.meshletCount = static_cast<uint32_t>(meshlets.size()) - lod.firstMeshlet;
+		}
+	}
+
+	const Model::Vertex* Model::Builder::GetVertexData() const
+	{
+		return cooked != nullptr ? cooked->vertices : vertices.data();
+	}
+
+	uint32_t Model::Builder::GetVertexCount() const
+	{
+		return cooked != nullptr ? cooked->vertexCount : static_cast<uint32_t>(vertices.size());
+	}
+
+	const uint32_t* Model::Builder::GetIndexData() const
+	{
+		return cooked != nullptr ? cooked->indices : indices.data();
+	}
+
+	uint32_t Model::Builder::GetIndexCount() const
+	{
+		return cooked != nullptr ? cooked->indexCount : static_cast<uint32_t>(indices.size());
+	}
+
+	const Model::Lod* Model::Builder::GetLodData() const
+	{
+		return cooked != nullptr ? cooked->lods : lods.data();
+	}
+
+	uint32_t Model::Builder::GetLodCount() const
+	{
+		return cooked != nullptr ? cooked->lodCount : static_cast<uint32_t>(lods.size());
+	}
+
+	const Model::Meshlet* Model::Builder::GetMeshletData() const
+	{
+		return cooked != nullptr ? cooked->meshlets : meshlets.data();
+	}
+
+	uint32_t Model::Builder::GetMeshletCount() const
+	{
+		return cooked != nullptr ? cooked->meshletCount : static_cast<uint32_t>(meshlets.size());
+	}
+
+	void Model::Builder::LoadObj(const std::string& filepath)
+	{
+		// One vertex per face corner, welded into unique vertices and indices below
+		std::vector<Vertex> corners;
+
+		if (!ObjParser::Parse(filepath, corners))
+		{
+			ERUPT_CORE_INFO("{0} has polygons with more than four corners, loading it with tinyobj", filepath);
+			ReadCornersWithTinyObj(filepath, corners);
 		}
+
+		VertexWelder::Weld(corners.data(), corners.size(), vertices, indices);
 	}
 }
\ No newline at end of file
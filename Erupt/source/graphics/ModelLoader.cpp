@@ -0,0 +1,115 @@
+#include "graphics/ModelLoader.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+
+namespace Erupt
+{
+	ModelLoader::ModelLoader(EruptDevice& device)
+		: m_Device(device)
+	{
+	}
+
+	ModelLoader::~ModelLoader()
+	{
+		// Whoever waited for these models is gone, finish them without callbacks
+		for (auto& load : m_Loads)
+		{
+			while (!Advance(*load, true))
+			{
+			}
+		}
+	}
+
+	std::shared_ptr<Model> ModelLoader::LoadAsync(const std::string& filepath, Model::VertexFormat format, Callback onLoaded)
+	{
+		auto load = std::make_unique<PendingLoad>();
+		load->model = std::shared_ptr<Model>(new Model(m_Device, filepath, format));
+		load->onLoaded = std::move(onLoaded);
+		load->builder.format = format;
+
+		PendingLoad* pending = load.get();
+		// Parsing takes long, in the background queue it never stalls a frame that waits for its own jobs
+		JobSystem::RunBackground([pending, filepath]()
+		{
+			pending->builder.LoadModel(filepath);
+		}, &pending->parsed);
+
+		m_Loads.push_back(std::move(load));
+		return m_Loads.back()->model;
+	}
+
+	void ModelLoader::Update()
+	{
+		std::vector<std::unique_ptr<PendingLoad>> finished;
+		for (auto& load : m_Loads)
+		{
+			if (Advance(*load, false))
+			{
+				finished.push_back(std::move(load));
+			}
+		}
+		m_Loads.erase(std::remove(m_Loads.begin(), m_Loads.end(), nullptr), m_Loads.end());
+
+		// Callbacks may start new loads
+		for (auto& load : finished)
+		{
+			if (load->onLoaded) load->onLoaded(load->model);
+		}
+	}
+
+	void ModelLoader::WaitIdle()
+	{
+		while (!m_Loads.empty())
+		{
+			std::vector<std::unique_ptr<PendingLoad>> loads = std::move(m_Loads);
+			m_Loads.clear();
+
+			for (auto& load : loads)
+			{
+				while (!Advance(*load, true))
+				{
+				}
+				if (load->onLoaded) load->onLoaded(load->model);
+			}
+		}
+	}
+
+	bool ModelLoader::Advance(PendingLoad& load, bool wait)
+	{
+		// Parsing
+		if (!load.uploaded)
+		{
+			if (!wait && !load.parsed.IsDone())
+			{
+				return false;
+			}
+
+			try
+			{
+				JobSystem::Wait(load.parsed);
+			}
+			catch (const std::exception& exception)
+			{
+				ERUPT_CORE_ERROR("Failed to load model {0}: {1}", load.model->GetFilePath(), exception.what());
+				return true;
+			}
+
+			ERUPT_CORE_INFO("Vertex count: {0}", load.builder.GetVertexCount());
+
+			load.model->Upload(load.builder);
+			load.uploaded = true;
+
+			// The CPU copy of the mesh is no longer needed
+			load.builder = Model::Builder{};
+		}
+
+		// Uploading, the copies are submitted with the next frame
+		if (wait)
+		{
+			m_Device.GetUploadQueue().Wait(load.model->m_UploadTicket);
+		}
+		return load.model->IsReady();
+	}
+}
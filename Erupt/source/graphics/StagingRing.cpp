@@ -0,0 +1,148 @@
+#include "graphics/StagingRing.h"
+
+#include "core/Log.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Erupt
+{
+	StagingRegion::~StagingRegion()
+	{
+		if (m_Ring)
+		{
+			m_Ring->Release(m_Begin);
+		}
+	}
+
+	StagingRegion::StagingRegion(StagingRegion&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	StagingRegion& StagingRegion::operator=(StagingRegion&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (m_Ring)
+			{
+				m_Ring->Release(m_Begin);
+			}
+
+			m_Ring = other.m_Ring;
+			m_Begin = other.m_Begin;
+			m_Buffer = other.m_Buffer;
+			m_Offset = other.m_Offset;
+			m_Size = other.m_Size;
+			m_Mapped = other.m_Mapped;
+			m_TemporaryBuffer = std::move(other.m_TemporaryBuffer);
+
+			other.m_Ring = nullptr;
+			other.m_Buffer = VK_NULL_HANDLE;
+			other.m_Mapped = nullptr;
+		}
+		return *this;
+	}
+
+	StagingRing::StagingRing(EruptDevice& device, VkDeviceSize capacity)
+		: m_Device(device), m_Capacity(capacity)
+	{
+		assert(capacity > 0 && capacity % DEFAULT_ALIGNMENT == 0 && "Invalid staging ring capacity!");
+
+		m_Buffer = std::make_unique<EruptBuffer>
+		(
+			m_Device,
+			capacity,
+			1,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		);
+		m_Buffer->Map();
+	}
+
+	StagingRing::~StagingRing()
+	{
+		Retire();
+		assert(m_Regions.empty() && "Staging regions must be destroyed before the ring!");
+	}
+
+	StagingRegion StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+	{
+		assert(size > 0 && alignment > 0 && (alignment & (alignment - 1)) == 0 && m_Capacity % alignment == 0 && "Invalid staging allocation!");
+
+		Retire();
+
+		StagingRegion region;
+		region.m_Size = size;
+
+		if (size <= m_Capacity / 2)
+		{
+			uint64_t position = (m_Head + alignment - 1) & ~(alignment - 1);
+
+			// Regions never straddle the end of the buffer, the rest of it is skipped
+			if (position % m_Capacity + size > m_Capacity)
+			{
+				position = (position / m_Capacity + 1) * m_Capacity;
+			}
+
+			if (position + size - m_Tail <= m_Capacity)
+			{
+				m_Regions.push_back({ m_Head, position + size, false });
+
+				region.m_Ring = this;
+				region.m_Begin = m_Head;
+				region.m_Buffer = m_Buffer->GetBuffer();
+				region.m_Offset = position % m_Capacity;
+				region.m_Mapped = static_cast<char*>(m_Buffer->GetMappedMemory()) + region.m_Offset;
+
+				m_Head = position + size;
+				m_RingAllocations++;
+				return region;
+			}
+		}
+
+		region.m_TemporaryBuffer = std::make_unique<EruptBuffer>
+		(
+			m_Device,
+			size,
+			1,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		);
+		region.m_TemporaryBuffer->Map();
+		region.m_Buffer = region.m_TemporaryBuffer->GetBuffer();
+		region.m_Mapped = region.m_TemporaryBuffer->GetMappedMemory();
+
+		m_TemporaryAllocations++;
+		return region;
+	}
+
+	StagingRing::Statistics StagingRing::GetStatistics() const
+	{
+		Statistics statistics{};
+		statistics.ringAllocations = m_RingAllocations;
+		statistics.temporaryAllocations = m_TemporaryAllocations;
+		statistics.inFlightBytes = m_Head - m_Tail;
+		return statistics;
+	}
+
+	void StagingRing::Release(uint64_t begin)
+	{
+		// Regions are mostly handed back in allocation order
+		auto region = std::find_if(m_Regions.begin(), m_Regions.end(), [&](const Region& other) { return other.begin == begin; });
+		assert(region != m_Regions.end() && !region->released && "Staging region released twice!");
+
+		region->released = true;
+		Retire();
+	}
+
+	void StagingRing::Retire()
+	{
+		// Space behind a region that is still in flight cannot be reused, even if later regions were handed back
+		while (!m_Regions.empty() && m_Regions.front().released)
+		{
+			m_Tail = m_Regions.front().end;
+			m_Regions.pop_front();
+		}
+	}
+}
@@ -0,0 +1,383 @@
+#include "graphics/UploadQueue.h"
+
+#include "core/Log.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace Erupt
+{
+	namespace
+	{
+		// Everything that may read uploaded data, and later copies that may overwrite it
+		constexpr VkPipelineStageFlags CONSUMER_STAGES =
+			VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+		constexpr VkAccessFlags CONSUMER_ACCESS =
+			VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT |
+			VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		VkCommandPool CreateCommandPool(VkDevice device, uint32_t queueFamily)
+		{
+			VkCommandPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.queueFamilyIndex = queueFamily;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+			VkCommandPool commandPool;
+			if (vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+			{
+				ERUPT_CORE_ERROR("Failed to create upload command pool!");
+				throw std::runtime_error("Failed to create upload command pool!");
+			}
+			return commandPool;
+		}
+	}
+
+	UploadQueue::UploadQueue(EruptDevice& device)
+		: m_Device(device)
+	{
+		QueueFamilyIndices indices = m_Device.FindPhysicalQueueFamilies();
+		m_GraphicsFamily = indices.graphicsFamily;
+		m_TransferFamily = indices.transferFamilyHasValue ? indices.transferFamily : indices.graphicsFamily;
+		m_TransferQueue = m_Device.TransferQueue();
+
+		m_CommandPool = CreateCommandPool(m_Device.Device(), m_TransferFamily);
+		if (IsDedicated())
+		{
+			m_AcquireCommandPool = CreateCommandPool(m_Device.Device(), m_GraphicsFamily);
+		}
+
+		m_Recording.ticket = 1;
+	}
+
+	UploadQueue::~UploadQueue()
+	{
+		WaitIdle();
+
+		vkDestroyCommandPool(m_Device.Device(), m_CommandPool, nullptr);
+		if (m_AcquireCommandPool != VK_NULL_HANDLE)
+		{
+			vkDestroyCommandPool(m_Device.Device(), m_AcquireCommandPool, nullptr);
+		}
+	}
+
+	UploadQueue::Ticket UploadQueue::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset)
+	{
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(GetCommandBuffer(), srcBuffer, dstBuffer, 1, &copyRegion);
+
+		if (IsDedicated())
+		{
+			VkBufferMemoryBarrier transfer{};
+			transfer.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			transfer.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			transfer.dstAccessMask = 0;
+			transfer.srcQueueFamilyIndex = m_TransferFamily;
+			transfer.dstQueueFamilyIndex = m_GraphicsFamily;
+			transfer.buffer = dstBuffer;
+			transfer.offset = dstOffset;
+			transfer.size = size;
+			m_Recording.bufferTransfers.push_back(transfer);
+		}
+
+		return m_Recording.ticket;
+	}
+
+	UploadQueue::Ticket UploadQueue::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount, VkDeviceSize bufferOffset)
+	{
+		VkBufferImageCopy region{};
+		region.bufferOffset = bufferOffset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = layerCount;
+
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { width, height, 1 };
+
+		vkCmdCopyBufferToImage(GetCommandBuffer(), buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		if (IsDedicated())
+		{
+			VkImageMemoryBarrier transfer{};
+			transfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			transfer.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			transfer.dstAccessMask = 0;
+			transfer.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			transfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			transfer.srcQueueFamilyIndex = m_TransferFamily;
+			transfer.dstQueueFamilyIndex = m_GraphicsFamily;
+			transfer.image = image;
+			transfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			transfer.subresourceRange.baseMipLevel = 0;
+			transfer.subresourceRange.levelCount = 1;
+			transfer.subresourceRange.baseArrayLayer = 0;
+			transfer.subresourceRange.layerCount = layerCount;
+			m_Recording.imageTransfers.push_back(transfer);
+		}
+
+		return m_Recording.ticket;
+	}
+
+	UploadQueue::Ticket UploadQueue::CopyUploadedBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset)
+	{
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = srcOffset;
+		copyRegion.dstOffset = dstOffset;
+		copyRegion.size = size;
+
+		const Ticket ticket = m_Recording.ticket;
+		VkCommandBuffer commandBuffer = GetCommandBuffer();
+
+		if (IsDedicated())
+		{
+			m_Recording.uploadedCopies.push_back({ srcBuffer, dstBuffer, copyRegion });
+			Submit();
+			return ticket;
+		}
+
+		// Earlier copies may have written the source, later ones may overwrite parts of the destination
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+		return ticket;
+	}
+
+	void UploadQueue::Retain(StagingRegion&& region)
+	{
+		m_Recording.stagingRegions.push_back(std::move(region));
+	}
+
+	UploadQueue::Ticket UploadQueue::GetTicket() const
+	{
+		return m_Recording.commandBuffer != VK_NULL_HANDLE ? m_Recording.ticket : m_Recording.ticket - 1;
+	}
+
+	void UploadQueue::Submit()
+	{
+		// Nothing reads staging memory that was retained without recording a copy
+		if (m_Recording.commandBuffer == VK_NULL_HANDLE)
+		{
+			m_Recording.stagingRegions.clear();
+			return;
+		}
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		if (vkCreateFence(m_Device.Device(), &fenceInfo, nullptr, &m_Recording.fence) != VK_SUCCESS)
+		{
+			ERUPT_CORE_ERROR("Failed to create fence!");
+			throw std::runtime_error("Failed to create fence!");
+		}
+
+		if (IsDedicated())
+		{
+			std::vector<VkBufferMemoryBarrier>& buffers = m_Recording.bufferTransfers;
+			std::vector<VkImageMemoryBarrier>& images = m_Recording.imageTransfers;
+
+			// Release the written ranges to the graphics family
+			vkCmdPipelineBarrier(m_Recording.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+				0, nullptr, static_cast<uint32_t>(buffers.size()), buffers.data(), static_cast<uint32_t>(images.size()), images.data());
+
+			m_Recording.transferred = CreateBatchSemaphore();
+
+			// Copies of uploaded data in an earlier batch may overlap the ranges written now
+			m_Recording.waited = m_CopiedSemaphore;
+			m_CopiedSemaphore = VK_NULL_HANDLE;
+
+			SubmitCommandBuffer(m_TransferQueue, m_Recording.commandBuffer, m_Recording.waited, VK_PIPELINE_STAGE_TRANSFER_BIT, m_Recording.transferred, VK_NULL_HANDLE);
+
+			// The acquire repeats the release barriers with the destination access, once the copies signaled the semaphore
+			for (VkBufferMemoryBarrier& barrier : buffers)
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = CONSUMER_ACCESS;
+			}
+			for (VkImageMemoryBarrier& barrier : images)
+			{
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = CONSUMER_ACCESS;
+			}
+
+			m_Recording.acquireCommandBuffer = BeginCommandBuffer(m_AcquireCommandPool);
+			vkCmdPipelineBarrier(m_Recording.acquireCommandBuffer, CONSUMER_STAGES, CONSUMER_STAGES, 0,
+				0, nullptr, static_cast<uint32_t>(buffers.size()), buffers.data(), static_cast<uint32_t>(images.size()), images.data());
+
+			if (!m_Recording.uploadedCopies.empty())
+			{
+				for (const UploadedCopy& copy : m_Recording.uploadedCopies)
+				{
+					vkCmdCopyBuffer(m_Recording.acquireCommandBuffer, copy.srcBuffer, copy.dstBuffer, 1, &copy.region);
+				}
+
+				VkMemoryBarrier barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+				barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.dstAccessMask = CONSUMER_ACCESS;
+				vkCmdPipelineBarrier(m_Recording.acquireCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, CONSUMER_STAGES,
+					0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+				m_Recording.copied = CreateBatchSemaphore();
+				m_CopiedSemaphore = m_Recording.copied;
+			}
+
+			SubmitCommandBuffer(m_Device.GraphicsQueue(), m_Recording.acquireCommandBuffer, m_Recording.transferred, CONSUMER_STAGES, m_Recording.copied, m_Recording.fence);
+
+			buffers.clear();
+			images.clear();
+		}
+		else
+		{
+			// Copies have to land before later submissions read or overwrite them
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = CONSUMER_ACCESS;
+			vkCmdPipelineBarrier(m_Recording.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, CONSUMER_STAGES,
+				0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			SubmitCommandBuffer(m_TransferQueue, m_Recording.commandBuffer, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, m_Recording.fence);
+		}
+
+		const Ticket next = m_Recording.ticket + 1;
+		m_InFlight.push_back(std::move(m_Recording));
+
+		m_Recording = Batch{};
+		m_Recording.ticket = next;
+	}
+
+	void UploadQueue::Update()
+	{
+		Submit();
+
+		while (!m_InFlight.empty() && vkGetFenceStatus(m_Device.Device(), m_InFlight.front().fence) == VK_SUCCESS)
+		{
+			Retire(m_InFlight.front());
+			m_InFlight.pop_front();
+		}
+	}
+
+	void UploadQueue::Wait(Ticket ticket)
+	{
+		assert(ticket <= m_Recording.ticket && "Ticket was never handed out!");
+
+		if (ticket == m_Recording.ticket)
+		{
+			Submit();
+		}
+
+		while (!m_InFlight.empty() && m_InFlight.front().ticket <= ticket)
+		{
+			Retire(m_InFlight.front());
+			m_InFlight.pop_front();
+		}
+	}
+
+	VkCommandBuffer UploadQueue::GetCommandBuffer()
+	{
+		if (m_Recording.commandBuffer == VK_NULL_HANDLE)
+		{
+			m_Recording.commandBuffer = BeginCommandBuffer(m_CommandPool);
+		}
+		return m_Recording.commandBuffer;
+	}
+
+	VkCommandBuffer UploadQueue::BeginCommandBuffer(VkCommandPool commandPool)
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = commandPool;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer commandBuffer;
+		if (vkAllocateCommandBuffers(m_Device.Device(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+		{
+			ERUPT_CORE_ERROR("Failed to allocate upload command buffer!");
+			throw std::runtime_error("Failed to allocate upload command buffer!");
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		vkBeginCommandBuffer(commandBuffer, &beginInfo);
+		return commandBuffer;
+	}
+
+	void UploadQueue::SubmitCommandBuffer(VkQueue queue, VkCommandBuffer commandBuffer, VkSemaphore waitSemaphore, VkPipelineStageFlags waitStages, VkSemaphore signalSemaphore, VkFence fence)
+	{
+		vkEndCommandBuffer(commandBuffer);
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.waitSemaphoreCount = waitSemaphore != VK_NULL_HANDLE ? 1 : 0;
+		submitInfo.pWaitSemaphores = &waitSemaphore;
+		submitInfo.pWaitDstStageMask = &waitStages;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+		submitInfo.signalSemaphoreCount = signalSemaphore != VK_NULL_HANDLE ? 1 : 0;
+		submitInfo.pSignalSemaphores = &signalSemaphore;
+
+		if (vkQueueSubmit(queue, 1, &submitInfo, fence) != VK_SUCCESS)
+		{
+			ERUPT_CORE_ERROR("Failed to submit upload command buffer!");
+			throw std::runtime_error("Failed to submit upload command buffer!");
+		}
+	}
+
+	VkSemaphore UploadQueue::CreateBatchSemaphore()
+	{
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		VkSemaphore semaphore;
+		if (vkCreateSemaphore(m_Device.Device(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+		{
+			ERUPT_CORE_ERROR("Failed to create semaphore!");
+			throw std::runtime_error("Failed to create semaphore!");
+		}
+		return semaphore;
+	}
+
+	void UploadQueue::Retire(Batch& batch)
+	{
+		// Waits for the fence, which already signaled unless called from Wait
+		vkWaitForFences(m_Device.Device(), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+		vkDestroyFence(m_Device.Device(), batch.fence, nullptr);
+
+		vkFreeCommandBuffers(m_Device.Device(), m_CommandPool, 1, &batch.commandBuffer);
+		if (batch.acquireCommandBuffer != VK_NULL_HANDLE)
+		{
+			vkFreeCommandBuffers(m_Device.Device(), m_AcquireCommandPool, 1, &batch.acquireCommandBuffer);
+			vkDestroySemaphore(m_Device.Device(), batch.transferred, nullptr);
+		}
+
+		// A copied semaphore belongs to the batch that waits for it, nothing has to wait anymore once it signaled
+		if (batch.waited != VK_NULL_HANDLE)
+		{
+			vkDestroySemaphore(m_Device.Device(), batch.waited, nullptr);
+		}
+		if (batch.copied != VK_NULL_HANDLE && batch.copied == m_CopiedSemaphore)
+		{
+			vkDestroySemaphore(m_Device.Device(), m_CopiedSemaphore, nullptr);
+			m_CopiedSemaphore = VK_NULL_HANDLE;
+		}
+		batch.stagingRegions.clear();
+
+		m_CompletedTicket = batch.ticket;
+	}
+}
@@ -0,0 +1,352 @@
+#include "graphics/mesh/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+namespace Erupt
+{
+	namespace
+	{
+		constexpr uint32_t INVALID_VERTEX = std::numeric_limits<uint32_t>::max();
+
+		// FIFO cache simulated with time stamps, a vertex is cached while fewer than cacheSize misses happened since it was loaded
+		class VertexCache
+		{
+		public:
+			VertexCache(size_t vertexCount, uint32_t cacheSize)
+				: m_Stamps(vertexCount, 0), m_CacheSize(cacheSize), m_Time(cacheSize + 1)
+			{
+			}
+
+			// Returns 1 if the vertex had to be transformed
+			inline uint32_t Access(uint32_t vertex)
+			{
+				if (m_Time - m_Stamps[vertex] > m_CacheSize)
+				{
+					m_Stamps[vertex] = m_Time++;
+					return 1;
+				}
+				return 0;
+			}
+
+			// Age of a vertex in misses, above the cache size once it was evicted
+			inline uint32_t Age(uint32_t vertex) const { return m_Time - m_Stamps[vertex]; }
+
+			inline void Flush() { m_Time += m_CacheSize + 1; }
+
+		private:
+			std::vector<uint32_t>	m_Stamps;
+			uint32_t				m_CacheSize;
+			uint32_t				m_Time;
+		};
+
+		// Triangles using every vertex, in compressed rows
+		struct TriangleAdjacency
+		{
+			std::vector<uint32_t> offsets;
+			std::vector<uint32_t> triangles;
+
+			TriangleAdjacency(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+				: offsets(vertexCount + 1, 0), triangles(indexCount)
+			{
+				for (size_t i = 0; i < indexCount; i++)
+				{
+					offsets[indices[i] + 1]++;
+				}
+				std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+				std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+				for (size_t i = 0; i < indexCount; i++)
+				{
+					triangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+		};
+	}
+
+	VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+	{
+		assert(indexCount % 3 == 0 && "Expected a triangle list");
+
+		VertexCache cache(vertexCount, cacheSize);
+		std::vector<bool> used(vertexCount, false);
+
+		size_t misses = 0;
+		size_t usedCount = 0;
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			misses += cache.Access(indices[i]);
+
+			if (!used[indices[i]])
+			{
+				used[indices[i]] = true;
+				usedCount++;
+			}
+		}
+
+		VertexCacheStatistics statistics{};
+		if (indexCount > 0)
+		{
+			statistics.acmr = float(misses) / float(indexCount / 3);
+			statistics.atvr = float(misses) / float(usedCount);
+		}
+		return statistics;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+	{
+		assert(indexCount % 3 == 0 && "Expected a triangle list");
+		assert(destination != indices && "Vertex cache optimization cannot run in place");
+
+		const TriangleAdjacency adjacency(indices, indexCount, vertexCount);
+
+		// Triangles that still have to be emitted per vertex
+		std::vector<uint32_t> liveCount(vertexCount);
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			liveCount[vertex] = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
+		}
+
+		std::vector<bool> emitted(indexCount / 3, false);
+		std::vector<uint32_t> deadEnds;
+		std::vector<uint32_t> candidates;
+		deadEnds.reserve(indexCount);
+
+		VertexCache cache(vertexCount, cacheSize);
+		size_t cursor = 0;
+		size_t written = 0;
+
+		// Next vertex in input order that still has triangles, once the fan and the dead end stack ran dry
+		auto nextLiveVertex = [&]() -> uint32_t
+		{
+			while (!deadEnds.empty())
+			{
+				const uint32_t vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (liveCount[vertex] > 0)
+				{
+					return vertex;
+				}
+			}
+
+			for (; cursor < vertexCount; cursor++)
+			{
+				if (liveCount[cursor] > 0)
+				{
+					return static_cast<uint32_t>(cursor);
+				}
+			}
+			return INVALID_VERTEX;
+		};
+
+		uint32_t fanning = nextLiveVertex();
+		while (fanning != INVALID_VERTEX)
+		{
+			candidates.clear();
+
+			// Emit every remaining triangle around the fanning vertex
+			for (uint32_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; i++)
+			{
+				const uint32_t triangle = adjacency.triangles[i];
+				if (emitted[triangle]) continue;
+				emitted[triangle] = true;
+
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					const uint32_t vertex = indices[triangle * 3 + corner];
+					destination[written++] = vertex;
+
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					liveCount[vertex]--;
+					cache.Access(vertex);
+				}
+			}
+
+			// Continue with the oldest candidate that stays cached while its own fan is emitted
+			uint32_t best = INVALID_VERTEX;
+			int64_t bestPriority = -1;
+			for (const uint32_t vertex : candidates)
+			{
+				if (liveCount[vertex] == 0) continue;
+
+				int64_t priority = 0;
+				if (cache.Age(vertex) + 2 * liveCount[vertex] <= cacheSize)
+				{
+					priority = cache.Age(vertex);
+				}
+				if (priority > bestPriority)
+				{
+					best = vertex;
+					bestPriority = priority;
+				}
+			}
+
+			fanning = best != INVALID_VERTEX ? best : nextLiveVertex();
+		}
+
+		assert(written == indexCount && "Every triangle is emitted exactly once");
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Model::Vertex>& vertices, float threshold, uint32_t cacheSize)
+	{
+		assert(indices.size() % 3 == 0 && "Expected a triangle list");
+
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		// Tipsify flushes the cache when it jumps to an unconnected part of the mesh, those jumps are the hard cluster boundaries
+		std::vector<uint32_t> hardBoundaries;
+		{
+			VertexCache cache(vertices.size(), cacheSize);
+			for (size_t triangle = 0; triangle < triangleCount; triangle++)
+			{
+				uint32_t misses = 0;
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					misses += cache.Access(indices[triangle * 3 + corner]);
+				}
+				if (triangle == 0 || misses == 3)
+				{
+					hardBoundaries.push_back(static_cast<uint32_t>(triangle));
+				}
+			}
+			hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		// Islands are split further wherever the part so far is within threshold of the island's cache efficiency,
+		// starting every cluster with an empty cache since it may end up anywhere in the draw order
+		std::vector<uint32_t> clusters;
+		{
+			VertexCache cache(vertices.size(), cacheSize);
+			auto accessTriangle = [&](size_t triangle)
+			{
+				return cache.Access(indices[triangle * 3 + 0]) + cache.Access(indices[triangle * 3 + 1]) + cache.Access(indices[triangle * 3 + 2]);
+			};
+
+			for (size_t island = 0; island + 1 < hardBoundaries.size(); island++)
+			{
+				const uint32_t first = hardBoundaries[island];
+				const uint32_t last = hardBoundaries[island + 1];
+
+				cache.Flush();
+				uint32_t islandMisses = 0;
+				for (uint32_t triangle = first; triangle < last; triangle++)
+				{
+					islandMisses += accessTriangle(triangle);
+				}
+				const float islandThreshold = threshold * float(islandMisses) / float(last - first);
+
+				cache.Flush();
+				clusters.push_back(first);
+				uint32_t clusterStart = first;
+				uint32_t clusterMisses = 0;
+
+				for (uint32_t triangle = first; triangle < last; triangle++)
+				{
+					clusterMisses += accessTriangle(triangle);
+
+					if (triangle + 1 < last && float(clusterMisses) / float(triangle + 1 - clusterStart) <= islandThreshold)
+					{
+						cache.Flush();
+						clusters.push_back(triangle + 1);
+						clusterStart = triangle + 1;
+						clusterMisses = 0;
+					}
+				}
+			}
+			clusters.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		const size_t clusterCount = clusters.size() - 1;
+
+		// Area weighted centroid and normal of every cluster
+		std::vector<glm::vec3> centroids(clusterCount, glm::vec3{ 0.f });
+		std::vector<glm::vec3> normals(clusterCount, glm::vec3{ 0.f });
+		glm::vec3 meshCentroid{ 0.f };
+		float meshArea = 0.f;
+
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			float clusterArea = 0.f;
+			for (uint32_t triangle = clusters[cluster]; triangle < clusters[cluster + 1]; triangle++)
+			{
+				const glm::vec3& a = vertices[indices[triangle * 3 + 0]].position;
+				const glm::vec3& b = vertices[indices[triangle * 3 + 1]].position;
+				const glm::vec3& c = vertices[indices[triangle * 3 + 2]].position;
+
+				const glm::vec3 normal = glm::cross(b - a, c - a);
+				const float area = glm::length(normal) * 0.5f;
+
+				centroids[cluster] += (a + b + c) * (area / 3.f);
+				normals[cluster] += normal;
+				clusterArea += area;
+			}
+
+			meshCentroid += centroids[cluster];
+			meshArea += clusterArea;
+
+			if (clusterArea > 0.f)
+			{
+				centroids[cluster] /= clusterArea;
+			}
+		}
+
+		if (meshArea > 0.f)
+		{
+			meshCentroid /= meshArea;
+		}
+
+		// Clusters facing away from the center occlude the rest of the mesh more often, so they are drawn first
+		std::vector<float> sortKeys(clusterCount, 0.f);
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			const float length = glm::length(normals[cluster]);
+			if (length > 0.f)
+			{
+				sortKeys[cluster] = glm::dot(centroids[cluster] - meshCentroid, normals[cluster] / length);
+			}
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<uint32_t> sorted;
+		sorted.reserve(indices.size());
+		for (const uint32_t cluster : order)
+		{
+			sorted.insert(sorted.end(), indices.begin() + size_t(clusters[cluster]) * 3, indices.begin() + size_t(clusters[cluster + 1]) * 3);
+		}
+
+		indices = std::move(sorted);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		std::vector<uint32_t> remap(vertices.size(), INVALID_VERTEX);
+		uint32_t next = 0;
+
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == INVALID_VERTEX)
+			{
+				remap[index] = next++;
+			}
+			index = remap[index];
+		}
+
+		std::vector<Model::Vertex> reordered(next);
+		for (size_t vertex = 0; vertex < vertices.size(); vertex++)
+		{
+			if (remap[vertex] != INVALID_VERTEX)
+			{
+				reordered[remap[vertex]] = vertices[vertex];
+			}
+		}
+
+		vertices = std::move(reordered);
+	}
+}
@@ -0,0 +1,329 @@
+#include "graphics/mesh/MeshSimplifier.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace Erupt
+{
+	namespace
+	{
+		// Sum of squared distances to a set of planes, weighted by the area of the triangles they came from
+		struct Quadric
+		{
+			double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+			double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+			double c = 0.0;
+			double weight = 0.0;
+
+			static Quadric FromPlane(const glm::dvec3& normal, double distance, double weight)
+			{
+				Quadric quadric;
+				quadric.a00 = normal.x * normal.x * weight;
+				quadric.a01 = normal.x * normal.y * weight;
+				quadric.a02 = normal.x * normal.z * weight;
+				quadric.a11 = normal.y * normal.y * weight;
+				quadric.a12 = normal.y * normal.z * weight;
+				quadric.a22 = normal.z * normal.z * weight;
+				quadric.b0 = normal.x * distance * weight;
+				quadric.b1 = normal.y * distance * weight;
+				quadric.b2 = normal.z * distance * weight;
+				quadric.c = distance * distance * weight;
+				quadric.weight = weight;
+				return quadric;
+			}
+
+			Quadric& operator+=(const Quadric& other)
+			{
+				a00 += other.a00; a01 += other.a01; a02 += other.a02;
+				a11 += other.a11; a12 += other.a12; a22 += other.a22;
+				b0 += other.b0; b1 += other.b1; b2 += other.b2;
+				c += other.c;
+				weight += other.weight;
+				return *this;
+			}
+
+			// RMS distance of point to the planes
+			float Error(const glm::vec3& point) const
+			{
+				if (weight <= 0.0) return 0.f;
+
+				const double x = point.x, y = point.y, z = point.z;
+				const double error =
+					a00 * x * x + a11 * y * y + a22 * z * z +
+					2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+					2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+				return static_cast<float>(std::sqrt(std::max(error, 0.0) / weight));
+			}
+		};
+
+		struct Collapse
+		{
+			float error;
+			uint32_t from;
+			uint32_t to;
+		};
+
+		inline glm::vec3 TriangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+		{
+			return glm::cross(b - a, c - a);
+		}
+	}
+
+	float MeshSimplifier::Simplify(std::vector<uint32_t>& destination, const uint32_t* indices, size_t indexCount, const std::vector<Model::Vertex>& vertices,
+		size_t targetIndexCount, float maxError)
+	{
+		assert(indexCount % 3 == 0 && "Expected a triangle list");
+
+		const size_t vertexCount = vertices.size();
+		destination.assign(indices, indices + indexCount);
+
+		// Vertices sharing a position are wedges of one corner, collapses and quadrics work on positions
+		std::vector<uint32_t> positionIds(vertexCount);
+		size_t positionCount = 0;
+		{
+			std::vector<uint32_t> order(vertexCount);
+			std::iota(order.begin(), order.end(), 0);
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+			{
+				const glm::vec3& p = vertices[a].position;
+				const glm::vec3& q = vertices[b].position;
+				return p.x != q.x ? p.x < q.x : p.y != q.y ? p.y < q.y : p.z < q.z;
+			});
+
+			for (size_t i = 0; i < vertexCount; i++)
+			{
+				if (i > 0 && vertices[order[i]].position != vertices[order[i - 1]].position)
+				{
+					positionCount++;
+				}
+				positionIds[order[i]] = static_cast<uint32_t>(positionCount);
+			}
+			positionCount += vertexCount > 0 ? 1 : 0;
+		}
+
+		auto positionOf = [&](uint32_t vertex) { return positionIds[vertex]; };
+
+		std::vector<uint32_t> wedgeCount(positionCount, 0);
+		{
+			std::vector<bool> referenced(vertexCount, false);
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				if (!referenced[indices[i]])
+				{
+					referenced[indices[i]] = true;
+					wedgeCount[positionOf(indices[i])]++;
+				}
+			}
+		}
+
+		std::vector<Quadric> quadrics(positionCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			const glm::dvec3 a = vertices[indices[i + 0]].position;
+			const glm::dvec3 b = vertices[indices[i + 1]].position;
+			const glm::dvec3 c = vertices[indices[i + 2]].position;
+
+			glm::dvec3 normal = glm::cross(b - a, c - a);
+			const double length = glm::length(normal);
+			if (length <= 0.0) continue;
+
+			normal /= length;
+			const Quadric plane = Quadric::FromPlane(normal, -glm::dot(normal, a), length * 0.5);
+
+			quadrics[positionOf(indices[i + 0])] += plane;
+			quadrics[positionOf(indices[i + 1])] += plane;
+			quadrics[positionOf(indices[i + 2])] += plane;
+		}
+
+		std::vector<uint64_t> edges;
+		std::vector<bool> locked(positionCount);
+		std::vector<bool> touched(positionCount);
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> remap(vertexCount);
+
+		float reachedError = 0.f;
+
+		// Every pass collapses a batch of the cheapest edges whose neighbourhoods do not overlap, then rebuilds the topology
+		while (destination.size() > targetIndexCount)
+		{
+			const size_t triangleCount = destination.size() / 3;
+
+			// Positions on borders or non manifold edges, every other edge is shared by exactly two triangles
+			edges.clear();
+			for (size_t i = 0; i < destination.size(); i += 3)
+			{
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					const uint64_t a = positionOf(destination[i + corner]);
+					const uint64_t b = positionOf(destination[i + (corner + 1) % 3]);
+					edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+
+			std::fill(locked.begin(), locked.end(), false);
+			for (size_t i = 0; i < edges.size();)
+			{
+				size_t run = i + 1;
+				while (run < edges.size() && edges[run] == edges[i])
+				{
+					run++;
+				}
+				if (run - i != 2)
+				{
+					locked[edges[i] >> 32] = true;
+					locked[edges[i] & 0xFFFFFFFFull] = true;
+				}
+				i = run;
+			}
+
+			for (size_t position = 0; position < positionCount; position++)
+			{
+				if (wedgeCount[position] != 1)
+				{
+					locked[position] = true;
+				}
+			}
+
+			// Triangles around every vertex
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (const uint32_t index : destination)
+			{
+				adjacencyOffsets[index + 1]++;
+			}
+			std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+
+			adjacency.resize(destination.size());
+			{
+				std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < destination.size(); i++)
+				{
+					adjacency[cursors[destination[i]]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			collapses.clear();
+			for (size_t i = 0; i < destination.size(); i += 3)
+			{
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					const uint32_t from = destination[i + corner];
+					if (locked[positionOf(from)]) continue;
+
+					for (const size_t other : { (corner + 1) % 3, (corner + 2) % 3 })
+					{
+						const uint32_t to = destination[i + other];
+						collapses.push_back({ quadrics[positionOf(from)].Error(vertices[to].position), from, to });
+					}
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b)
+			{
+				return a.error < b.error || (a.error == b.error && (a.from < b.from || (a.from == b.from && a.to < b.to)));
+			});
+
+			std::iota(remap.begin(), remap.end(), 0);
+			std::fill(touched.begin(), touched.end(), false);
+
+			const size_t trianglesToRemove = (destination.size() - targetIndexCount + 2) / 3;
+			size_t removedTriangles = 0;
+			size_t collapseCount = 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.error > maxError || removedTriangles >= trianglesToRemove) break;
+
+				const uint32_t from = collapse.from;
+				const uint32_t to = collapse.to;
+				const uint32_t fromPosition = positionOf(from);
+				const uint32_t toPosition = positionOf(to);
+
+				if (touched[fromPosition] || touched[toPosition]) continue;
+
+				// The neighbourhood must be untouched by this pass, and no remaining triangle may flip
+				bool valid = true;
+				size_t collapsedTriangles = 0;
+
+				for (uint32_t i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1] && valid; i++)
+				{
+					const uint32_t* triangle = &destination[size_t(adjacency[i]) * 3];
+
+					bool containsTo = false;
+					for (size_t corner = 0; corner < 3; corner++)
+					{
+						valid = valid && !touched[positionOf(triangle[corner])];
+						containsTo = containsTo || positionOf(triangle[corner]) == toPosition;
+					}
+
+					if (containsTo)
+					{
+						collapsedTriangles++;
+						continue;
+					}
+
+					glm::vec3 corners[3] = { vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position };
+					const glm::vec3 before = TriangleNormal(corners[0], corners[1], corners[2]);
+					for (glm::vec3& corner : corners)
+					{
+						if (corner == vertices[from].position)
+						{
+							corner = vertices[to].position;
+						}
+					}
+					const glm::vec3 after = TriangleNormal(corners[0], corners[1], corners[2]);
+
+					valid = valid && glm::dot(before, after) > 0.f;
+				}
+
+				if (!valid) continue;
+
+				remap[from] = to;
+				quadrics[toPosition] += quadrics[fromPosition];
+				reachedError = std::max(reachedError, collapse.error);
+				removedTriangles += collapsedTriangles;
+				collapseCount++;
+
+				for (uint32_t i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1]; i++)
+				{
+					const uint32_t* triangle = &destination[size_t(adjacency[i]) * 3];
+					touched[positionOf(triangle[0])] = true;
+					touched[positionOf(triangle[1])] = true;
+					touched[positionOf(triangle[2])] = true;
+				}
+			}
+
+			if (collapseCount == 0) break;
+
+			// Collapsed vertices only had a single wedge, their position disappears from the mesh
+			size_t written = 0;
+			for (size_t triangle = 0; triangle < triangleCount; triangle++)
+			{
+				const uint32_t a = remap[destination[triangle * 3 + 0]];
+				const uint32_t b = remap[destination[triangle * 3 + 1]];
+				const uint32_t c = remap[destination[triangle * 3 + 2]];
+
+				if (positionOf(a) == positionOf(b) || positionOf(b) == positionOf(c) || positionOf(a) == positionOf(c)) continue;
+
+				destination[written++] = a;
+				destination[written++] = b;
+				destination[written++] = c;
+			}
+			destination.resize(written);
+
+			for (size_t vertex = 0; vertex < vertexCount; vertex++)
+			{
+				if (remap[vertex] != vertex)
+				{
+					wedgeCount[positionOf(uint32_t(vertex))] = 0;
+				}
+			}
+		}
+
+		return reachedError;
+	}
+}
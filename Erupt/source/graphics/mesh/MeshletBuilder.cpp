@@ -0,0 +1,133 @@
+#include "graphics/mesh/MeshletBuilder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Erupt
+{
+	namespace
+	{
+		// Normal cones whose triangles deviate further than this cosine from the axis are never culled,
+		// back facing clusters that wide are too rare to be worth testing
+		constexpr float MIN_CONE_COSINE = 0.1f;
+	}
+
+	void MeshletBuilder::Build(const std::vector<uint32_t>& indices, uint32_t firstIndex, uint32_t indexCount, const std::vector<Model::Vertex>& vertices, std::vector<Model::Meshlet>& meshlets)
+	{
+		assert(indexCount % 3 == 0 && "Expected a triangle list");
+		assert(uint64_t(firstIndex) + indexCount <= indices.size() && "Range outside of the index buffer");
+
+		constexpr uint32_t NO_MESHLET = std::numeric_limits<uint32_t>::max();
+
+		// Meshlet that last used every vertex, avoids clearing a set per meshlet
+		std::vector<uint32_t> lastMeshlet(vertices.size(), NO_MESHLET);
+
+		Model::Meshlet meshlet{};
+		meshlet.firstIndex = firstIndex;
+		uint32_t meshletId = static_cast<uint32_t>(meshlets.size());
+		uint32_t vertexCount = 0;
+
+		for (uint32_t i = firstIndex; i < firstIndex + indexCount; i += 3)
+		{
+			uint32_t newVertices = 0;
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t vertex = indices[i + corner];
+				// Repeated corners of degenerate triangles are only counted once
+				const bool seen = lastMeshlet[vertex] == meshletId ||
+					(corner > 0 && indices[i] == vertex) || (corner > 1 && indices[i + 1] == vertex);
+				newVertices += seen ? 0 : 1;
+			}
+
+			if (vertexCount + newVertices > MAX_VERTICES || meshlet.indexCount / 3 + 1 > MAX_TRIANGLES)
+			{
+				ComputeBounds(meshlet, indices, vertices);
+				meshlets.push_back(meshlet);
+
+				meshlet = Model::Meshlet{};
+				meshlet.firstIndex = i;
+				meshletId++;
+				vertexCount = 0;
+			}
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				const uint32_t vertex = indices[i + corner];
+				if (lastMeshlet[vertex] != meshletId)
+				{
+					lastMeshlet[vertex] = meshletId;
+					vertexCount++;
+				}
+			}
+			meshlet.indexCount += 3;
+		}
+
+		if (meshlet.indexCount > 0)
+		{
+			ComputeBounds(meshlet, indices, vertices);
+			meshlets.push_back(meshlet);
+		}
+	}
+
+	void MeshletBuilder::ComputeBounds(Model::Meshlet& meshlet, const std::vector<uint32_t>& indices, const std::vector<Model::Vertex>& vertices)
+	{
+		const uint32_t* triangles = indices.data() + meshlet.firstIndex;
+
+		// Sphere around the center of the bounding box, slightly larger than the minimal one but cheap and stable
+		glm::vec3 min{ std::numeric_limits<float>::max() };
+		glm::vec3 max{ std::numeric_limits<float>::lowest() };
+		for (uint32_t i = 0; i < meshlet.indexCount; i++)
+		{
+			min = glm::min(min, vertices[triangles[i]].position);
+			max = glm::max(max, vertices[triangles[i]].position);
+		}
+
+		meshlet.center = (min + max) * 0.5f;
+		meshlet.radius = 0.f;
+		for (uint32_t i = 0; i < meshlet.indexCount; i++)
+		{
+			meshlet.radius = std::max(meshlet.radius, glm::length(vertices[triangles[i]].position - meshlet.center));
+		}
+
+		// Normal cone around the average facing, from the winding of the triangles rather than the vertex normals
+		std::vector<glm::vec3> normals;
+		normals.reserve(meshlet.indexCount / 3);
+
+		glm::vec3 axis{ 0.f };
+		for (uint32_t i = 0; i < meshlet.indexCount; i += 3)
+		{
+			const glm::vec3& a = vertices[triangles[i + 0]].position;
+			const glm::vec3& b = vertices[triangles[i + 1]].position;
+			const glm::vec3& c = vertices[triangles[i + 2]].position;
+
+			const glm::vec3 normal = glm::cross(b - a, c - a);
+			const float length = glm::length(normal);
+			if (length <= 0.f) continue;
+
+			normals.push_back(normal / length);
+			axis += normals.back();
+		}
+
+		meshlet.coneAxis = glm::vec3{ 0.f };
+		meshlet.coneCutoff = 1.f;
+
+		const float axisLength = glm::length(axis);
+		if (axisLength <= 0.f) return;
+
+		axis /= axisLength;
+
+		float minCosine = 1.f;
+		for (const glm::vec3& normal : normals)
+		{
+			minCosine = std::min(minCosine, glm::dot(axis, normal));
+		}
+
+		meshlet.coneAxis = axis;
+		if (minCosine > MIN_CONE_COSINE)
+		{
+			meshlet.coneCutoff = std::sqrt(1.f - minCosine * minCosine);
+		}
+	}
+}
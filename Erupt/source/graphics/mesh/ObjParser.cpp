@@ -0,0 +1,573 @@
+#include "graphics/mesh/ObjParser.h"
+
+#include "core/FileIO.h"
+#include "core/JobSystem.h"
+#include "core/Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace Erupt
+{
+	namespace
+	{
+		inline bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+		inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+		inline bool IsLineEnd(char c) { return c == '\n' || c == '\r'; }
+
+		enum class LineType
+		{
+			Other,
+			Position,
+			Normal,
+			TexCoord,
+			Face
+		};
+
+		// Skips the leading whitespace and the keyword of a line
+		inline LineType Classify(const char*& p, const char* end)
+		{
+			while (p < end && IsSpace(*p)) p++;
+
+			if (end - p < 2)
+			{
+				return LineType::Other;
+			}
+
+			if (p[0] == 'v')
+			{
+				if (IsSpace(p[1]))
+				{
+					p += 2;
+					return LineType::Position;
+				}
+				if (end - p >= 3 && IsSpace(p[2]) && (p[1] == 'n' || p[1] == 't'))
+				{
+					const LineType type = p[1] == 'n' ? LineType::Normal : LineType::TexCoord;
+					p += 3;
+					return type;
+				}
+				return LineType::Other;
+			}
+
+			if (p[0] == 'f' && IsSpace(p[1]))
+			{
+				p += 2;
+				return LineType::Face;
+			}
+
+			return LineType::Other;
+		}
+
+		// Calls func(begin, end) for every line in [begin, end), a lone '\r' also ends a line like in tinyobj
+		template<typename Func>
+		void ForEachLine(const char* begin, const char* end, Func&& func)
+		{
+			const char* p = begin;
+			while (p < end)
+			{
+				const char* lineEnd = p;
+				while (lineEnd < end && !IsLineEnd(*lineEnd)) lineEnd++;
+
+				func(p, lineEnd);
+				p = lineEnd + 1;
+			}
+		}
+
+		// tinyobj's tryParseDouble, the arithmetic has to stay the same to produce bit identical values
+		bool TryParseDouble(const char* s, const char* end, double* result)
+		{
+			if (s >= end)
+			{
+				return false;
+			}
+
+			static const double powLut[] = { 1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001 };
+			constexpr int lutEntries = sizeof(powLut) / sizeof(powLut[0]);
+
+			double mantissa = 0.0;
+			int exponent = 0;
+			char sign = '+';
+			char exponentSign = '+';
+			const char* current = s;
+			int read = 0;
+			bool leadingDecimalDot = false;
+
+			if (*current == '+' || *current == '-')
+			{
+				sign = *current;
+				current++;
+				leadingDecimalDot = current != end && *current == '.';
+			}
+			else if (*current == '.')
+			{
+				leadingDecimalDot = true;
+			}
+			else if (!IsDigit(*current))
+			{
+				return false;
+			}
+
+			if (!leadingDecimalDot)
+			{
+				while (current != end && IsDigit(*current))
+				{
+					mantissa *= 10;
+					mantissa += static_cast<int>(*current - '0');
+					current++;
+					read++;
+				}
+
+				if (read == 0)
+				{
+					return false;
+				}
+			}
+
+			if (current != end && *current == '.')
+			{
+				current++;
+				read = 1;
+				while (current != end && IsDigit(*current))
+				{
+					mantissa += static_cast<int>(*current - '0') * (read < lutEntries ? powLut[read] : std::pow(10.0, -read));
+					read++;
+					current++;
+				}
+			}
+
+			if (current != end && (*current == 'e' || *current == 'E'))
+			{
+				current++;
+				if (current != end && (*current == '+' || *current == '-'))
+				{
+					exponentSign = *current;
+					current++;
+				}
+				else if (current == end || !IsDigit(*current))
+				{
+					return false;
+				}
+
+				read = 0;
+				while (current != end && IsDigit(*current))
+				{
+					if (exponent > 2147483647 / 10)
+					{
+						return false;
+					}
+					exponent *= 10;
+					exponent += static_cast<int>(*current - '0');
+					current++;
+					read++;
+				}
+				exponent *= exponentSign == '+' ? 1 : -1;
+
+				if (read == 0)
+				{
+					return false;
+				}
+			}
+
+			*result = (sign == '+' ? 1 : -1) * (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+			return true;
+		}
+
+		inline const char* TokenEnd(const char* p, const char* end)
+		{
+			while (p < end && !IsSpace(*p)) p++;
+			return p;
+		}
+
+		inline bool ParseReal(const char*& p, const char* end, float& value)
+		{
+			while (p < end && IsSpace(*p)) p++;
+			const char* tokenEnd = TokenEnd(p, end);
+
+			double result;
+			const bool parsed = TryParseDouble(p, tokenEnd, &result);
+			if (parsed)
+			{
+				value = static_cast<float>(result);
+			}
+
+			p = tokenEnd;
+			return parsed;
+		}
+
+		inline float ParseReal(const char*& p, const char* end, double defaultValue = 0.0)
+		{
+			float value = static_cast<float>(defaultValue);
+			ParseReal(p, end, value);
+			return value;
+		}
+
+		// atoi on the rest of the line, which is what tinyobj reads face indices with
+		inline int ParseInt(const char* p, const char* end)
+		{
+			while (p < end && (IsSpace(*p) || *p == '\v' || *p == '\f')) p++;
+
+			bool negative = false;
+			if (p < end && (*p == '+' || *p == '-'))
+			{
+				negative = *p == '-';
+				p++;
+			}
+
+			int64_t value = 0;
+			while (p < end && IsDigit(*p) && value <= INT32_MAX)
+			{
+				value = value * 10 + (*p - '0');
+				p++;
+			}
+
+			return static_cast<int>(negative ? -value : value);
+		}
+
+		inline void SkipIndex(const char*& p, const char* end)
+		{
+			while (p < end && *p != '/' && !IsSpace(*p)) p++;
+		}
+
+		// 1 based to 0 based, negative indices are relative to the attributes defined so far
+		inline bool FixIndex(int index, int64_t count, int32_t& result, bool allowZero)
+		{
+			if (index > 0)
+			{
+				result = index - 1;
+				return true;
+			}
+			if (index == 0)
+			{
+				result = -1;
+				return allowZero;
+			}
+
+			const int64_t relative = count + index;
+			result = static_cast<int32_t>(relative);
+			return relative >= 0;
+		}
+
+		struct Triple
+		{
+			int32_t position = -1;
+			int32_t texCoord = -1;
+			int32_t normal = -1;
+		};
+
+		// v, v/vt, v//vn or v/vt/vn
+		bool ParseTriple(const char*& p, const char* end, int64_t positionCount, int64_t normalCount, int64_t texCoordCount, Triple& triple)
+		{
+			triple = Triple{};
+
+			if (!FixIndex(ParseInt(p, end), positionCount, triple.position, false)) return false;
+			SkipIndex(p, end);
+			if (p == end || *p != '/') return true;
+			p++;
+
+			if (p < end && *p == '/')
+			{
+				p++;
+				if (!FixIndex(ParseInt(p, end), normalCount, triple.normal, true)) return false;
+				SkipIndex(p, end);
+				return true;
+			}
+
+			if (!FixIndex(ParseInt(p, end), texCoordCount, triple.texCoord, true)) return false;
+			SkipIndex(p, end);
+			if (p == end || *p != '/') return true;
+			p++;
+
+			if (!FixIndex(ParseInt(p, end), normalCount, triple.normal, true)) return false;
+			SkipIndex(p, end);
+			return true;
+		}
+
+		struct Chunk
+		{
+			const char* begin;
+			const char* end;
+
+			size_t positionCount = 0;
+			size_t normalCount = 0;
+			size_t texCoordCount = 0;
+			size_t positionBase = 0;
+			size_t normalBase = 0;
+			size_t texCoordBase = 0;
+
+			std::vector<Triple> faceCorners;
+			std::vector<uint32_t> faceSizes;
+			size_t cornerCount = 0;		// after triangulation
+			size_t cornerBase = 0;
+		};
+
+		struct Attributes
+		{
+			std::vector<glm::vec3> positions;
+			std::vector<glm::vec3> colors;
+			std::vector<glm::vec3> normals;
+			std::vector<glm::vec2> texCoords;
+		};
+
+		void ParseChunk(Chunk& chunk, Attributes& attributes, std::atomic<bool>& supported, const std::string& filePath)
+		{
+			size_t position = chunk.positionBase;
+			size_t normal = chunk.normalBase;
+			size_t texCoord = chunk.texCoordBase;
+
+			ForEachLine(chunk.begin, chunk.end, [&](const char* p, const char* end)
+			{
+				const char* line = p;
+
+				switch (Classify(p, end))
+				{
+					case LineType::Position:
+					{
+						glm::vec3& vertex = attributes.positions[position];
+						vertex.x = ParseReal(p, end);
+						vertex.y = ParseReal(p, end);
+						vertex.z = ParseReal(p, end);
+
+						// Vertices without (complete) colors are white
+						glm::vec3& color = attributes.colors[position];
+						if (!(ParseReal(p, end, color.r) && ParseReal(p, end, color.g) && ParseReal(p, end, color.b)))
+						{
+							color = glm::vec3(1.f);
+						}
+
+						position++;
+						break;
+					}
+					case LineType::Normal:
+					{
+						glm::vec3& vertexNormal = attributes.normals[normal++];
+						vertexNormal.x = ParseReal(p, end);
+						vertexNormal.y = ParseReal(p, end);
+						vertexNormal.z = ParseReal(p, end);
+						break;
+					}
+					case LineType::TexCoord:
+					{
+						glm::vec2& uv = attributes.texCoords[texCoord++];
+						uv.x = ParseReal(p, end);
+						uv.y = ParseReal(p, end);
+						break;
+					}
+					case LineType::Face:
+					{
+						if (!supported.load(std::memory_order_relaxed))
+						{
+							return;
+						}
+
+						while (p < end && IsSpace(*p)) p++;
+
+						uint32_t size = 0;
+						bool forwardReference = false;
+						while (p < end)
+						{
+							Triple triple;
+							if (!ParseTriple(p, end, position, normal, texCoord, triple))
+							{
+								ERUPT_CORE_ERROR("Failed to parse face in {0}: {1}", filePath, std::string(line, end));
+								throw std::runtime_error("Failed to parse face in " + filePath);
+							}
+
+							forwardReference |= static_cast<size_t>(triple.position) >= position;
+							chunk.faceCorners.push_back(triple);
+							size++;
+
+							while (p < end && IsSpace(*p)) p++;
+						}
+
+						// tinyobj ear clips larger polygons and splits quads with positions known at that point of the file
+						if (size > 4 || (size == 4 && forwardReference))
+						{
+							supported.store(false, std::memory_order_relaxed);
+							return;
+						}
+
+						chunk.faceSizes.push_back(size);
+						chunk.cornerCount += size == 4 ? 6 : (size == 3 ? 3 : 0);
+						break;
+					}
+					case LineType::Other:
+						break;
+				}
+			});
+		}
+
+		// Same vertex Model::Builder built from tinyobj's index
+		inline Model::Vertex MakeVertex(const Triple& triple, const Attributes& attributes, const std::string& filePath)
+		{
+			if (static_cast<size_t>(triple.position) >= attributes.positions.size() ||
+				(triple.normal >= 0 && static_cast<size_t>(triple.normal) >= attributes.normals.size()) ||
+				(triple.texCoord >= 0 && static_cast<size_t>(triple.texCoord) >= attributes.texCoords.size()))
+			{
+				ERUPT_CORE_ERROR("Face in {0} references an attribute that does not exist", filePath);
+				throw std::runtime_error("Face index out of range in " + filePath);
+			}
+
+			Model::Vertex vertex{};
+			vertex.position = attributes.positions[triple.position];
+			vertex.color = attributes.colors[triple.position];
+
+			if (triple.normal >= 0)
+			{
+				vertex.normal = attributes.normals[triple.normal];
+			}
+			if (triple.texCoord >= 0)
+			{
+				vertex.uv = attributes.texCoords[triple.texCoord];
+			}
+
+			return vertex;
+		}
+
+		void TriangulateChunk(const Chunk& chunk, const Attributes& attributes, Model::Vertex* corners, const std::string& filePath)
+		{
+			const Triple* face = chunk.faceCorners.data();
+			Model::Vertex* out = corners + chunk.cornerBase;
+
+			for (uint32_t size : chunk.faceSizes)
+			{
+				if (size == 3)
+				{
+					*out++ = MakeVertex(face[0], attributes, filePath);
+					*out++ = MakeVertex(face[1], attributes, filePath);
+					*out++ = MakeVertex(face[2], attributes, filePath);
+				}
+				else if (size == 4)
+				{
+					const glm::vec3& v0 = attributes.positions[face[0].position];
+					const glm::vec3& v1 = attributes.positions[face[1].position];
+					const glm::vec3& v2 = attributes.positions[face[2].position];
+					const glm::vec3& v3 = attributes.positions[face[3].position];
+
+					// Split along the shorter diagonal, written out like tinyobj to get the same rounding
+					const float e02x = v2.x - v0.x;
+					const float e02y = v2.y - v0.y;
+					const float e02z = v2.z - v0.z;
+					const float e13x = v3.x - v1.x;
+					const float e13y = v3.y - v1.y;
+					const float e13z = v3.z - v1.z;
+
+					const float sqr02 = e02x * e02x + e02y * e02y + e02z * e02z;
+					const float sqr13 = e13x * e13x + e13y * e13y + e13z * e13z;
+
+					static const int split02[6] = { 0, 1, 2, 0, 2, 3 };
+					static const int split13[6] = { 0, 1, 3, 1, 2, 3 };
+					const int* order = sqr02 < sqr13 ? split02 : split13;
+
+					for (int i = 0; i < 6; i++)
+					{
+						*out++ = MakeVertex(face[order[i]], attributes, filePath);
+					}
+				}
+
+				face += size;
+			}
+		}
+	}
+
+	bool ObjParser::Parse(const std::string& filePath, std::vector<Model::Vertex>& corners)
+	{
+		MappedFile file(filePath);
+
+		const char* data = reinterpret_cast<const char*>(file.Data());
+		const char* dataEnd = data + file.Size();
+
+		// Chunk boundaries are moved to the start of the next line
+		const size_t threadCount = JobSystem::GetThreadCount();
+		const size_t chunkCount = std::max<size_t>(1, std::min(threadCount * 4, file.Size() / MIN_CHUNK_SIZE));
+		const size_t chunkSize = file.Size() / chunkCount;
+
+		std::vector<Chunk> chunks;
+		chunks.reserve(chunkCount);
+
+		const char* begin = data;
+		for (size_t i = 0; i < chunkCount && begin < dataEnd; i++)
+		{
+			const char* end = i + 1 == chunkCount ? dataEnd : std::max(begin, data + (i + 1) * chunkSize);
+			while (end < dataEnd && !IsLineEnd(end[-1])) end++;
+
+			chunks.push_back(Chunk{ begin, end });
+			begin = end;
+		}
+
+		JobSystem::ParallelFor(chunks.size(), 1, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				Chunk& chunk = chunks[i];
+				ForEachLine(chunk.begin, chunk.end, [&chunk](const char* p, const char* end)
+				{
+					switch (Classify(p, end))
+					{
+						case LineType::Position:	chunk.positionCount++; break;
+						case LineType::Normal:		chunk.normalCount++; break;
+						case LineType::TexCoord:	chunk.texCoordCount++; break;
+						default: break;
+					}
+				});
+			}
+		});
+
+		size_t positionCount = 0;
+		size_t normalCount = 0;
+		size_t texCoordCount = 0;
+		for (Chunk& chunk : chunks)
+		{
+			chunk.positionBase = positionCount;
+			chunk.normalBase = normalCount;
+			chunk.texCoordBase = texCoordCount;
+
+			positionCount += chunk.positionCount;
+			normalCount += chunk.normalCount;
+			texCoordCount += chunk.texCoordCount;
+		}
+
+		Attributes attributes;
+		attributes.positions.resize(positionCount);
+		attributes.colors.resize(positionCount);
+		attributes.normals.resize(normalCount);
+		attributes.texCoords.resize(texCoordCount);
+
+		std::atomic<bool> supported = true;
+
+		JobSystem::ParallelFor(chunks.size(), 1, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				ParseChunk(chunks[i], attributes, supported, filePath);
+			}
+		});
+
+		if (!supported)
+		{
+			return false;
+		}
+
+		size_t cornerCount = 0;
+		for (Chunk& chunk : chunks)
+		{
+			chunk.cornerBase = cornerCount;
+			cornerCount += chunk.cornerCount;
+		}
+
+		corners.resize(cornerCount);
+
+		JobSystem::ParallelFor(chunks.size(), 1, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				TriangulateChunk(chunks[i], attributes, corners.data(), filePath);
+			}
+		});
+
+		return true;
+	}
+}
@@ -0,0 +1,123 @@
+#include "graphics/mesh/VertexPacking.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Erupt
+{
+	namespace
+	{
+		inline float SignNotZero(float value)
+		{
+			return value >= 0.f ? 1.f : -1.f;
+		}
+
+		// Flat axes would divide by zero, they decode to the minimum instead
+		inline glm::vec3 SafeExtent(const Model::Bounds& bounds)
+		{
+			glm::vec3 extent = bounds.max - bounds.min;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (!(extent[axis] > 0.f))
+				{
+					extent[axis] = 1.f;
+				}
+			}
+			return extent;
+		}
+	}
+
+	void VertexPacking::Pack(const Model::Vertex* vertices, size_t count, Model::VertexFormat format, const Model::Bounds& bounds, Model::PackedVertex* out)
+	{
+		assert(format != Model::VertexFormat::Full && "Full vertices are uploaded as they are");
+
+		const bool quantized = format == Model::VertexFormat::PackedQuantized;
+		const glm::vec3 inverseExtent = 1.f / SafeExtent(bounds);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const Model::Vertex& vertex = vertices[i];
+			Model::PackedVertex packed;
+
+			if (quantized)
+			{
+				const glm::vec3 position = (vertex.position - bounds.min) * inverseExtent;
+				packed.position[0] = glm::packUnorm1x16(position.x);
+				packed.position[1] = glm::packUnorm1x16(position.y);
+				packed.position[2] = glm::packUnorm1x16(position.z);
+				packed.position[3] = 0;
+			}
+			else
+			{
+				packed.position[0] = glm::packHalf1x16(vertex.position.x);
+				packed.position[1] = glm::packHalf1x16(vertex.position.y);
+				packed.position[2] = glm::packHalf1x16(vertex.position.z);
+				packed.position[3] = 0;
+			}
+
+			const glm::vec2 normal = OctahedralEncode(vertex.normal);
+			packed.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(normal.x));
+			packed.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(normal.y));
+
+			const glm::vec3 color = glm::clamp(vertex.color, 0.f, 1.f);
+			packed.color[0] = static_cast<uint8_t>(std::lround(color.r * 255.f));
+			packed.color[1] = static_cast<uint8_t>(std::lround(color.g * 255.f));
+			packed.color[2] = static_cast<uint8_t>(std::lround(color.b * 255.f));
+			packed.color[3] = 255;
+
+			packed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+			packed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+			out[i] = packed;
+		}
+	}
+
+	glm::mat4 VertexPacking::GetPositionDecodeMatrix(Model::VertexFormat format, const Model::Bounds& bounds)
+	{
+		if (format != Model::VertexFormat::PackedQuantized)
+		{
+			return glm::mat4{ 1.f };
+		}
+
+		const glm::vec3 extent = SafeExtent(bounds);
+
+		glm::mat4 decode{ 1.f };
+		decode[0][0] = extent.x;
+		decode[1][1] = extent.y;
+		decode[2][2] = extent.z;
+		decode[3] = glm::vec4(bounds.min, 1.f);
+		return decode;
+	}
+
+	glm::vec2 VertexPacking::OctahedralEncode(const glm::vec3& normal)
+	{
+		const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (!(length > 0.f))
+		{
+			// Models without normals keep a zero vector in Vertex, the closest packed value is +z
+			return glm::vec2{ 0.f };
+		}
+
+		const glm::vec3 n = normal / length;
+		if (n.z >= 0.f)
+		{
+			return glm::vec2{ n.x, n.y };
+		}
+
+		return glm::vec2{ (1.f - std::abs(n.y)) * SignNotZero(n.x), (1.f - std::abs(n.x)) * SignNotZero(n.y) };
+	}
+
+	glm::vec3 VertexPacking::OctahedralDecode(const glm::vec2& encoded)
+	{
+		glm::vec3 n{ encoded.x, encoded.y, 1.f - std::abs(encoded.x) - std::abs(encoded.y) };
+
+		const float t = std::max(-n.z, 0.f);
+		n.x += n.x >= 0.f ? -t : t;
+		n.y += n.y >= 0.f ? -t : t;
+
+		return glm::normalize(n);
+	}
+}
@@ -0,0 +1,327 @@
+#include "graphics/mesh/VertexWelder.h"
+
+#include "core/JobSystem.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Erupt
+{
+	namespace
+	{
+		constexpr size_t KEY_WORDS = sizeof(Model::Vertex) / sizeof(uint32_t);
+		static_assert(sizeof(Model::Vertex) == KEY_WORDS * sizeof(float), "Vertices are welded bytewise and must be tightly packed floats");
+
+		constexpr uint32_t EMPTY_SLOT = std::numeric_limits<uint32_t>::max();
+		constexpr size_t HASH_GRAIN_SIZE = 1 << 14;
+		constexpr size_t MAX_SHARD_BITS = 8;
+
+		// The bytes a vertex is compared by
+		struct VertexKey
+		{
+			uint32_t words[KEY_WORDS];
+
+			inline bool operator==(const VertexKey& other) const { return std::memcmp(words, other.words, sizeof(words)) == 0; }
+		};
+
+		inline VertexKey MakeKey(const Model::Vertex& vertex, float inverseEpsilon)
+		{
+			VertexKey key;
+			std::memcpy(key.words, &vertex, sizeof(key.words));
+
+			if (inverseEpsilon > 0.f)
+			{
+				for (size_t i = 0; i < KEY_WORDS; i++)
+				{
+					float value;
+					std::memcpy(&value, &key.words[i], sizeof(value));
+
+					// NaNs keep their bits, everything else becomes its (clamped) grid cell
+					const double cell = std::floor(double(value) * inverseEpsilon + 0.5);
+					if (cell == cell)
+					{
+						const double clamped = std::clamp(cell, double(std::numeric_limits<int32_t>::min()), double(std::numeric_limits<int32_t>::max()));
+						key.words[i] = static_cast<uint32_t>(static_cast<int32_t>(clamped));
+					}
+				}
+			}
+			else
+			{
+				// -0 and +0 compare equal in Vertex::operator==, keep it that way
+				for (uint32_t& word : key.words)
+				{
+					if (word == 0x80000000u)
+					{
+						word = 0;
+					}
+				}
+			}
+
+			return key;
+		}
+
+		inline uint32_t HashKey(const VertexKey& key)
+		{
+			constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+
+			uint64_t hash = 0;
+			size_t i = 0;
+			for (; i + 1 < KEY_WORDS; i += 2)
+			{
+				const uint64_t word = uint64_t(key.words[i]) | (uint64_t(key.words[i + 1]) << 32);
+				hash = (((hash << 23) | (hash >> 41)) ^ word) * multiplier;
+			}
+			if (i < KEY_WORDS)
+			{
+				hash = (((hash << 23) | (hash >> 41)) ^ key.words[i]) * multiplier;
+			}
+
+			hash ^= hash >> 33;
+			hash *= 0xFF51AFD7ED558CCDull;
+			hash ^= hash >> 33;
+			return static_cast<uint32_t>(hash);
+		}
+
+		inline float InverseEpsilon(float epsilon)
+		{
+			return epsilon > 0.f ? 1.f / epsilon : 0.f;
+		}
+
+		// Linear probing table of (hash, vertex index) pairs, kept at most half full
+		class WeldTable
+		{
+		public:
+			explicit WeldTable(size_t expectedCount)
+			{
+				size_t capacity = 64;
+				while (capacity < expectedCount * 2)
+				{
+					capacity *= 2;
+				}
+				m_Slots.assign(capacity, Slot{ 0, EMPTY_SLOT });
+				m_Mask = capacity - 1;
+			}
+
+			// Returns the index of a stored vertex for which equal(index) holds, or stores and returns index
+			template<typename Equal>
+			uint32_t FindOrInsert(uint32_t hash, uint32_t index, Equal&& equal)
+			{
+				size_t position = hash & m_Mask;
+
+				while (true)
+				{
+					Slot& slot = m_Slots[position];
+
+					if (slot.index == EMPTY_SLOT)
+					{
+						slot = Slot{ hash, index };
+						if (++m_Size * 2 > m_Slots.size())
+						{
+							Grow();
+						}
+						return index;
+					}
+
+					if (slot.hash == hash && equal(slot.index))
+					{
+						return slot.index;
+					}
+
+					position = (position + 1) & m_Mask;
+				}
+			}
+
+		private:
+			struct Slot
+			{
+				uint32_t hash;
+				uint32_t index;
+			};
+
+			void Grow()
+			{
+				std::vector<Slot> old = std::move(m_Slots);
+				m_Slots.assign(old.size() * 2, Slot{ 0, EMPTY_SLOT });
+				m_Mask = m_Slots.size() - 1;
+
+				for (const Slot& slot : old)
+				{
+					if (slot.index == EMPTY_SLOT) continue;
+
+					size_t position = slot.hash & m_Mask;
+					while (m_Slots[position].index != EMPTY_SLOT)
+					{
+						position = (position + 1) & m_Mask;
+					}
+					m_Slots[position] = slot;
+				}
+			}
+
+		private:
+			std::vector<Slot>	m_Slots;
+			size_t				m_Mask = 0;
+			size_t				m_Size = 0;
+		};
+	}
+
+	void VertexWelder::Weld(const Model::Vertex* stream, size_t count, std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon)
+	{
+		if (count >= PARALLEL_THRESHOLD && JobSystem::GetThreadCount() > 1)
+		{
+			WeldParallel(stream, count, vertices, indices, epsilon);
+		}
+		else
+		{
+			WeldSerial(stream, count, vertices, indices, epsilon);
+		}
+	}
+
+	void VertexWelder::WeldSerial(const Model::Vertex* stream, size_t count, std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon)
+	{
+		assert(count < EMPTY_SLOT && "Vertex stream too large for 32 bit indices");
+
+		const float inverseEpsilon = InverseEpsilon(epsilon);
+
+		vertices.clear();
+		indices.resize(count);
+
+		// Indexed meshes usually share every vertex between several corners
+		WeldTable table(count / 4);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const VertexKey key = MakeKey(stream[i], inverseEpsilon);
+			const uint32_t next = static_cast<uint32_t>(vertices.size());
+
+			const uint32_t index = table.FindOrInsert(HashKey(key), next, [&](uint32_t other)
+			{
+				return MakeKey(vertices[other], inverseEpsilon) == key;
+			});
+
+			if (index == next)
+			{
+				vertices.push_back(stream[i]);
+			}
+			indices[i] = index;
+		}
+	}
+
+	void VertexWelder::WeldParallel(const Model::Vertex* stream, size_t count, std::vector<Model::Vertex>& vertices, std::vector<uint32_t>& indices, float epsilon)
+	{
+		assert(count < EMPTY_SLOT && "Vertex stream too large for 32 bit indices");
+
+		const float inverseEpsilon = InverseEpsilon(epsilon);
+
+		std::vector<uint32_t> hashes(count);
+		JobSystem::ParallelFor(count, HASH_GRAIN_SIZE, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				hashes[i] = HashKey(MakeKey(stream[i], inverseEpsilon));
+			}
+		});
+
+		// Equal vertices have equal hashes, so shards selected by the top hash bits never share a vertex.
+		// The table position uses the low bits, which keeps both independent
+		size_t shardBits = 0;
+		while (shardBits < MAX_SHARD_BITS && (size_t(1) << shardBits) < size_t(JobSystem::GetThreadCount()) * 4)
+		{
+			shardBits++;
+		}
+		const size_t shardCount = size_t(1) << shardBits;
+		const uint32_t shardShift = 32 - static_cast<uint32_t>(shardBits);
+
+		auto shardOf = [shardBits, shardShift](uint32_t hash) -> size_t
+		{
+			return shardBits == 0 ? 0 : hash >> shardShift;
+		};
+
+		// Stable counting sort of the stream positions by shard, every shard sees its vertices in stream order
+		std::vector<size_t> shardOffsets(shardCount + 1, 0);
+		for (size_t i = 0; i < count; i++)
+		{
+			shardOffsets[shardOf(hashes[i]) + 1]++;
+		}
+		for (size_t shard = 0; shard < shardCount; shard++)
+		{
+			shardOffsets[shard + 1] += shardOffsets[shard];
+		}
+
+		std::vector<uint32_t> order(count);
+		{
+			std::vector<size_t> cursors(shardOffsets.begin(), shardOffsets.end() - 1);
+			for (size_t i = 0; i < count; i++)
+			{
+				order[cursors[shardOf(hashes[i])]++] = static_cast<uint32_t>(i);
+			}
+		}
+
+		// indices temporarily holds the stream position of the first equal vertex
+		indices.resize(count);
+		JobSystem::ParallelFor(shardCount, 1, [&](size_t begin, size_t end)
+		{
+			for (size_t shard = begin; shard < end; shard++)
+			{
+				const size_t first = shardOffsets[shard];
+				const size_t last = shardOffsets[shard + 1];
+				WeldTable table((last - first) / 4);
+
+				for (size_t j = first; j < last; j++)
+				{
+					const uint32_t i = order[j];
+					const VertexKey key = MakeKey(stream[i], inverseEpsilon);
+
+					indices[i] = table.FindOrInsert(hashes[i], i, [&](uint32_t other)
+					{
+						return MakeKey(stream[other], inverseEpsilon) == key;
+					});
+				}
+			}
+		});
+
+		// Number the first occurrences in stream order, order is reused to hold the new vertex indices
+		const size_t blockCount = (count + HASH_GRAIN_SIZE - 1) / HASH_GRAIN_SIZE;
+		std::vector<uint32_t> blockOffsets(blockCount + 1, 0);
+
+		JobSystem::ParallelFor(count, HASH_GRAIN_SIZE, [&](size_t begin, size_t end)
+		{
+			uint32_t unique = 0;
+			for (size_t i = begin; i < end; i++)
+			{
+				unique += indices[i] == i;
+			}
+			blockOffsets[begin / HASH_GRAIN_SIZE + 1] = unique;
+		});
+		for (size_t block = 0; block < blockCount; block++)
+		{
+			blockOffsets[block + 1] += blockOffsets[block];
+		}
+
+		vertices.resize(blockOffsets[blockCount]);
+
+		JobSystem::ParallelFor(count, HASH_GRAIN_SIZE, [&](size_t begin, size_t end)
+		{
+			uint32_t next = blockOffsets[begin / HASH_GRAIN_SIZE];
+			for (size_t i = begin; i < end; i++)
+			{
+				if (indices[i] == i)
+				{
+					order[i] = next;
+					vertices[next] = stream[i];
+					next++;
+				}
+			}
+		});
+
+		JobSystem::ParallelFor(count, HASH_GRAIN_SIZE, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				indices[i] = order[indices[i]];
+			}
+		});
+	}
+}
@@ -73,21 +73,14 @@ namespace Erupt
 
 	void PointLightSystem::Update(FrameInfo& frameInfo, GlobalUbo& ubo)
 	{
-		auto rotateLight = glm::rotate(glm::mat4(1.f), frameInfo.deltaTime, { 0.f, -1.f, 0.f });
 		int lightIndex = 0;
-		for (auto& kv : frameInfo.entities)
+		for (auto [entity, transform, color, pointLight] : frameInfo.entities.View<TransformComponent, ColorComponent, PointLightComponent>())
 		{
-			auto& entity = kv.second;
-			if (entity.pointLight == nullptr) continue;
-
 			assert(lightIndex < MAX_LIGHTS && "Point lights exceed maximum specified");
 
-			// update light position
-			entity.m_Transform.translation = glm::vec3(rotateLight * glm::vec4(entity.m_Transform.translation, 1.f));
-
 			// copy light to ubo
-			ubo.pointLights[lightIndex].position = glm::vec4(entity.m_Transform.translation, 1.f);
-			ubo.pointLights[lightIndex].color = glm::vec4(entity.m_Color, entity.pointLight->lightIntensity);
+			ubo.pointLights[lightIndex].position = glm::vec4(transform.GetInterpolatedWorldTranslation(frameInfo.interpolationAlpha), 1.f);
+			ubo.pointLights[lightIndex].color = glm::vec4(color.color, pointLight.lightIntensity);
 
 			lightIndex += 1;
 		}
@@ -105,19 +98,16 @@ namespace Erupt
 			0,
 			1,
 			&frameInfo.globalDescriptorSet,
-			0,
-			nullptr
+			1,
+			&frameInfo.globalUboOffset
 		);
 
-		for (auto& kv : frameInfo.entities)
+		for (auto [entity, transform, color, pointLight] : frameInfo.entities.View<TransformComponent, ColorComponent, PointLightComponent>())
 		{
-			auto& entity = kv.second;
-			if (entity.pointLight == nullptr) continue;
-
 			PointLightPushConstants push{};
-			push.position = glm::vec4(entity.m_Transform.translation, 1.f);
-			push.color = glm::vec4(entity.m_Color, entity.pointLight->lightIntensity);
-			push.radius = entity.m_Transform.scale.x;
+			push.position = glm::vec4(transform.GetInterpolatedWorldTranslation(frameInfo.interpolationAlpha), 1.f);
+			push.color = glm::vec4(color.color, pointLight.lightIntensity);
+			push.radius = transform.GetScale().x;
 
 			vkCmdPushConstants(
 				frameInfo.commandBuffer,
@@ -129,6 +119,5 @@ namespace Erupt
 			);
 			vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
 		}
-
 	}
 }
\ No newline at end of file
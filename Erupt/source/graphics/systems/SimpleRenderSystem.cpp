@@ -1,10 +1,58 @@
 #include "graphics/systems/SimpleRenderSystem.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/MeshletCulling.h"
 
 #include "core/FileIO.h"
 #include "core/Log.h"
 
+#include <limits>
+
 namespace Erupt
 {
+	namespace
+	{
+		// Simplification error that may show on screen, as a fraction of the screen height (about a pixel at 1080p)
+		constexpr float LOD_ERROR_THRESHOLD = 1.f / 1080.f;
+
+		// A coarser level is only picked once its error is this much below the threshold, so entities near a switching
+		// distance do not pop back and forth
+		constexpr float LOD_HYSTERESIS = 0.25f;
+
+		// Object space distance to fraction of the screen height for the closest point of the model's bounding sphere.
+		// Infinite if the sphere reaches the camera plane
+		float ProjectedErrorScale(const Camera& camera, const glm::mat4& world, const Model::Bounds& bounds)
+		{
+			const float scale = glm::sqrt(glm::max(glm::max(glm::dot(world[0], world[0]), glm::dot(world[1], world[1])), glm::dot(world[2], world[2])));
+			const float radius = glm::length(bounds.max - bounds.min) * 0.5f * scale;
+			const glm::vec4 center = camera.GetView() * world * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.f);
+
+			// Clip space w of the closest point, the depth for perspective and 1 for orthographic projections
+			const glm::mat4& projection = camera.GetProjection();
+			const float w = projection[2][3] * (center.z - radius) + projection[3][3];
+
+			if (w <= 0.f)
+			{
+				return std::numeric_limits<float>::infinity();
+			}
+			return scale * glm::abs(projection[1][1]) * 0.5f / w;
+		}
+
+		uint32_t SelectLod(const std::vector<Model::Lod>& lods, uint32_t current, float errorScale)
+		{
+			uint32_t lod = std::min(current, static_cast<uint32_t>(lods.size()) - 1);
+
+			while (lod > 0 && lods[lod].error * errorScale > LOD_ERROR_THRESHOLD)
+			{
+				lod--;
+			}
+			while (lod + 1 < lods.size() && lods[lod + 1].error * errorScale <= LOD_ERROR_THRESHOLD * (1.f - LOD_HYSTERESIS))
+			{
+				lod++;
+			}
+			return lod;
+		}
+	}
+
 	struct SimplePushConstantData
 	{
 		glm::mat4 modelMatrix{ 1.f };
@@ -55,23 +103,31 @@ namespace Erupt
 	{
 		assert(m_PipelineLayout != nullptr && "Cannot create pipeline before pipeline layout!");
 
-		PipelineConfigInfo pipelineConfig{};
-		EruptPipeline::DefaultPipelineConfigInfo(pipelineConfig);
-		pipelineConfig.renderPass = renderPass;
-		pipelineConfig.pipelineLayout = m_PipelineLayout;
-
-		m_EruptPipeline = std::make_unique<EruptPipeline>(
-			m_EruptDevice,
-			"shaders/compiled/simple_shader.vert.spv",
-			"shaders/compiled/simple_shader.frag.spv",
-			pipelineConfig
-			);
+		for (size_t i = 0; i < m_EruptPipelines.size(); i++)
+		{
+			const Model::VertexFormat format = static_cast<Model::VertexFormat>(i);
+
+			PipelineConfigInfo pipelineConfig{};
+			EruptPipeline::DefaultPipelineConfigInfo(pipelineConfig);
+			pipelineConfig.bindingDescriptions = Model::GetBindingDescriptions(format);
+			pipelineConfig.attributeDescriptions = Model::GetAttributeDescriptions(format);
+			pipelineConfig.renderPass = renderPass;
+			pipelineConfig.pipelineLayout = m_PipelineLayout;
+
+			// Cone culling drops back facing meshlets, which is only invisible if the rasterizer drops them too
+			m_CullBackfaces = (pipelineConfig.rasterizationInfo.cullMode & VK_CULL_MODE_BACK_BIT) != 0;
+
+			m_EruptPipelines[i] = std::make_unique<EruptPipeline>(
+				m_EruptDevice,
+				format == Model::VertexFormat::Full ? "shaders/compiled/simple_shader.vert.spv" : "shaders/compiled/simple_shader_packed.vert.spv",
+				"shaders/compiled/simple_shader.frag.spv",
+				pipelineConfig
+				);
+		}
 	}
 
 	void SimpleRenderSystem::RenderEntities(FrameInfo& frameInfo)
 	{
-		m_EruptPipeline->Bind(frameInfo.commandBuffer);
-
 		vkCmdBindDescriptorSets(
 			frameInfo.commandBuffer,
 			VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -79,23 +135,46 @@ namespace Erupt
 			0, 
 			1,
 			&frameInfo.globalDescriptorSet,
-			0, 
-			nullptr
+			1,
+			&frameInfo.globalUboOffset
 		);
 
-		for (auto& kv : frameInfo.entities)
+		// All models live in the geometry pool, its vertex buffer stays bound across pipeline changes
+		const GeometryPool& geometryPool = m_EruptDevice.GetGeometryPool();
+		geometryPool.BindVertexBuffer(frameInfo.commandBuffer);
+
+		Model::VertexFormat boundFormat = Model::VertexFormat::Count;
+		VkIndexType boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
+		const glm::vec4 cameraPosition = glm::inverse(frameInfo.camera.GetView())[3];
+
+		for (auto [entity, transform, model] : frameInfo.entities.View<TransformComponent, ModelComponent>())
 		{
-			auto& entity = kv.second;
+			// Still streaming in, see ModelLoader
+			if (!model.model || !model.model->IsReady()) continue;
+
+			const glm::mat4 worldMatrix = transform.GetInterpolatedWorldMatrix(frameInfo.interpolationAlpha);
+			model.lod = SelectLod(model.model->GetLods(), model.lod, ProjectedErrorScale(frameInfo.camera, worldMatrix, model.model->GetBounds()));
+
+			// Frustum and cone tests run in object space, see MeshletCulling
+			const MeshletCulling culling(
+				frameInfo.camera.GetProjection() * frameInfo.camera.GetView() * worldMatrix,
+				glm::vec3(glm::inverse(worldMatrix) * cameraPosition),
+				m_CullBackfaces);
 
-			// If the object does not have a model there is no need to render it
-			if (entity.m_Model == nullptr) continue;
+			m_VisibleRanges.clear();
+			if (!culling.CullModel(*model.model, model.lod, m_VisibleRanges)) continue;
 
-			if(entity.GetId() != 2)
-				entity.m_Transform.rotation.y += 1.f * frameInfo.deltaTime;
+			const Model::VertexFormat format = model.model->GetVertexFormat();
+			if (format != boundFormat)
+			{
+				m_EruptPipelines[static_cast<size_t>(format)]->Bind(frameInfo.commandBuffer);
+				boundFormat = format;
+			}
 
 			SimplePushConstantData push{};
-			push.modelMatrix = entity.m_Transform.mat4();
-			push.normalMatrix = entity.m_Transform.normalMatrix();
+			// Packed positions are stored relative to the model bounds, decoding them is part of the model matrix
+			push.modelMatrix = worldMatrix * model.model->GetPositionDecodeMatrix();
+			push.normalMatrix = transform.GetInterpolatedWorldNormalMatrix(frameInfo.interpolationAlpha);
 
 			vkCmdPushConstants(
 				frameInfo.commandBuffer,
@@ -105,8 +184,21 @@ namespace Erupt
 				sizeof(SimplePushConstantData),
 				&push);
 
-			entity.m_Model->Bind(frameInfo.commandBuffer);
-			entity.m_Model->Draw(frameInfo.commandBuffer);
+			if (model.model->IsIndexed() && model.model->GetIndexType() != boundIndexType)
+			{
+				boundIndexType = model.model->GetIndexType();
+				geometryPool.BindIndexBuffer(frameInfo.commandBuffer, boundIndexType);
+			}
+
+			// Without meshlets the whole lod is drawn
+			if (m_VisibleRanges.empty())
+			{
+				model.model->Draw(frameInfo.commandBuffer, model.lod);
+			}
+			for (const Model::IndexRange& range : m_VisibleRanges)
+			{
+				model.model->DrawRange(frameInfo.commandBuffer, range);
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -1,13 +1,25 @@
 #include "core/Application.h"
 
-int main()
+#include <cstring>
+
+// "Sandbox" runs the demo scene, "Sandbox scene.escene" runs a saved scene instead and
+// "Sandbox --save-scene scene.escene" writes the demo scene to the file before running it. Paths are relative to the resources folder
+int main(int argc, char** argv)
 {
+	const bool saveScene = argc == 3 && std::strcmp(argv[1], "--save-scene") == 0;
+	const std::string scenePath = argc == 2 ? argv[1] : "";
+
 	//This is cursed
 	Erupt::Application::Init();
-	Erupt::Application engine = Erupt::Application();
+	Erupt::Application engine = Erupt::Application(scenePath);
 
 	try
 	{
+		if (saveScene)
+		{
+			engine.SaveScene(argv[2]);
+		}
+
 		engine.Run();
 	}
 	catch (const std::exception& e)